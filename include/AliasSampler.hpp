@@ -0,0 +1,61 @@
+#pragma once
+
+#include "dd/DDDefinitions.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A histogram mapping the indices of sampled outcomes to their counts.
+ */
+using IndexHistogram = std::unordered_map<std::size_t, std::size_t>;
+
+/**
+ * Sampling from a discrete distribution using Walker's alias method. After a
+ * linear-time setup, every sample costs two random numbers and one table
+ * lookup, independent of the number of outcomes.
+ *
+ * Each table entry stores the probability of keeping the drawn column in its
+ * real part and the index of the alias column in its imaginary part. This
+ * allows building the table directly in the memory of an amplitude vector.
+ */
+class AliasSampler {
+public:
+  /**
+   * Construct a sampler for the given (not necessarily normalized) weights.
+   */
+  explicit AliasSampler(const std::vector<dd::fp>& weights);
+
+  /**
+   * Construct a sampler for the measurement outcomes of a state vector. The
+   * table is built in the memory of the given vector, which is consumed.
+   */
+  explicit AliasSampler(std::vector<std::complex<dd::fp>>&& amplitudes);
+
+  /**
+   * Draw a single sample.
+   * @param mt random number generator to use
+   * @return the index of the sampled outcome
+   */
+  [[nodiscard]] std::size_t operator()(std::mt19937_64& mt) const;
+
+  /**
+   * Draw samples from the distribution.
+   * @param shots number of samples to draw
+   * @param mt random number generator to use
+   * @return a histogram of the sampled outcome indices
+   */
+  [[nodiscard]] IndexHistogram sample(std::size_t shots,
+                                      std::mt19937_64& mt) const;
+
+  [[nodiscard]] std::size_t size() const { return table.size(); }
+
+private:
+  // expects the (unnormalized) weights in the real parts of the table
+  void build();
+
+  std::vector<std::complex<dd::fp>> table;
+};
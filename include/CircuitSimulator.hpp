@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Definitions.hpp"
+#include "PackedBitString.hpp"
 #include "Simulator.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
+#include "dd/Node.hpp"
 #include "ir/QuantumComputation.hpp"
 #include "ir/operations/NonUnitaryOperation.hpp"
 #include "ir/operations/Operation.hpp"
@@ -13,8 +15,10 @@
 #include <istream>
 #include <map>
 #include <memory>
+#include <set>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 
 struct ApproximationInfo {
@@ -85,18 +89,111 @@ public:
   }
 
   std::map<std::string, std::size_t> simulate(std::size_t shots) override;
+  PackedHistogram simulateCompact(std::size_t shots) override;
 
   virtual dd::fp expectationValue(const qc::QuantumComputation& observable);
 
   std::map<std::string, std::string> additionalStatistics() override {
-    return {
+    auto statistics = Simulator<Config>::gcPolicy.statistics();
+    statistics.insert({
         {"step_fidelity", std::to_string(approximationInfo.stepFidelity)},
         {"approximation_runs", std::to_string(approximationRuns)},
         {"final_fidelity", std::to_string(finalFidelity)},
         {"single_shots", std::to_string(singleShots)},
-    };
+        {"fused_gates", std::to_string(fusedGates)},
+        {"unfused_gates", std::to_string(unfusedGates)},
+        {"prefix_cache_hits", std::to_string(prefixCacheHits)},
+        {"outcome_branches", std::to_string(outcomeBranches)},
+        {"pruned_branches", std::to_string(prunedBranches)},
+        {"branch_memo_hits", std::to_string(branchMemoHits)},
+        {"memory_budget", std::to_string(memoryBudget)},
+        {"peak_memory", std::to_string(peakMemory)},
+        {"budget_garbage_collections",
+         std::to_string(budgetGarbageCollections)},
+        {"budget_compute_table_flushes",
+         std::to_string(budgetComputeTableFlushes)},
+        {"budget_approximations", std::to_string(budgetApproximations)},
+        {"budget_violations", std::to_string(budgetViolations)},
+        {"budget_fidelity_loss", std::to_string(1.0L - budgetFidelity)},
+    });
+    return statistics;
   };
 
+  /**
+   * Enable the gate fusion pre-pass. Consecutive unitary gates whose combined
+   * support does not exceed `maxQubits` qubits are multiplied into a single
+   * matrix DD before being applied to the state.
+   * @param maxQubits maximum number of qubits a fused block may act on (0
+   * disables fusion)
+   */
+  void setMaxFusionQubits(const std::size_t maxQubits) {
+    maxFusionQubits = maxQubits;
+  }
+  [[nodiscard]] std::size_t getMaxFusionQubits() const {
+    return maxFusionQubits;
+  }
+
+  /**
+   * Set the number of threads used for simulating the individual shots of
+   * dynamic circuits. Each thread owns a separate DD package. Shots are
+   * processed in fixed-size blocks with their own random seeds so that the
+   * result for a fixed seed does not depend on the number of threads.
+   * @param nthreads number of threads (0 keeps the serial single-package mode)
+   */
+  void setShotThreads(const std::size_t nthreads) { shotThreads = nthreads; }
+  [[nodiscard]] std::size_t getShotThreads() const { return shotThreads; }
+
+  /**
+   * Enable or disable caching of the state reached right before the first
+   * non-unitary operation of a dynamic circuit. If enabled, every shot after
+   * the first one starts from the cached state instead of re-simulating the
+   * unitary prefix of the circuit. Disabled by default.
+   */
+  void setPrefixCaching(const bool enable) { prefixCaching = enable; }
+  [[nodiscard]] bool getPrefixCaching() const { return prefixCaching; }
+
+  /**
+   * Enable or disable the exact simulation of dynamic circuits by branching
+   * on the outcomes of mid-circuit measurements and resets. Instead of
+   * re-simulating the circuit for every shot, both post-measurement states
+   * are explored, the distribution over all classical outcomes is computed
+   * once, and the shots are sampled from it.
+   * @param enable whether to use measurement branching
+   * @param pruningThreshold branches whose probability falls below this
+   * threshold are not explored any further
+   */
+  void setMeasurementBranching(const bool enable,
+                               const dd::fp pruningThreshold = 0.) {
+    measurementBranching = enable;
+    branchPruningThreshold = pruningThreshold;
+  }
+  [[nodiscard]] bool getMeasurementBranching() const {
+    return measurementBranching;
+  }
+  [[nodiscard]] const std::map<std::string, dd::fp>&
+  getOutcomeProbabilities() const {
+    return outcomeProbabilities;
+  }
+
+  /**
+   * Limit the memory used by the decision diagrams during the simulation.
+   * After every gate, the memory occupied by vector and matrix nodes is
+   * estimated. Whenever it exceeds the budget, the simulator escalates from
+   * garbage collection over flushing the compute tables to approximating the
+   * state with an increasingly lower fidelity until the budget is met again.
+   * The peak memory reports the largest usage kept after enforcing the
+   * budget.
+   * @param bytes memory budget in bytes (0 disables the budget)
+   * @param minFidelity lowest fidelity a single approximation may target
+   */
+  void setMemoryBudget(const std::size_t bytes,
+                       const dd::fp minFidelity = 0.5) {
+    memoryBudget = bytes;
+    minBudgetFidelity = minFidelity;
+  }
+  [[nodiscard]] std::size_t getMemoryBudget() const { return memoryBudget; }
+  [[nodiscard]] std::size_t getPeakMemory() const { return peakMemory; }
+
   [[nodiscard]] std::size_t getNumberOfQubits() const override {
     return qc->getNqubits();
   };
@@ -115,6 +212,47 @@ protected:
   std::size_t approximationRuns{0};
   long double finalFidelity{1.0L};
 
+  std::size_t shotThreads{0};
+  static constexpr std::size_t SHOTS_PER_BLOCK = 64;
+
+  bool prefixCaching{false};
+  bool prefixCached{false};
+  std::size_t prefixLength{0};
+  std::size_t prefixCacheHits{0};
+  dd::vEdge prefixState{};
+
+  bool measurementBranching{false};
+  dd::fp branchPruningThreshold{0.};
+  std::size_t outcomeBranches{0};
+  std::size_t prunedBranches{0};
+  std::size_t branchMemoHits{0};
+  std::map<std::string, dd::fp> outcomeProbabilities;
+
+  // conditional outcome distributions of already explored branches, keyed by
+  // position in the circuit, the (normalized) state, and the classical values
+  using BranchKey = std::tuple<std::size_t, std::size_t, const dd::vNode*,
+                               std::string>;
+  std::map<BranchKey, std::pair<dd::vEdge, std::map<std::string, dd::fp>>>
+      branchMemo;
+
+  std::size_t memoryBudget{0};
+  dd::fp minBudgetFidelity{0.5};
+  std::size_t peakMemory{0};
+  std::size_t budgetGarbageCollections{0};
+  std::size_t budgetComputeTableFlushes{0};
+  std::size_t budgetApproximations{0};
+  std::size_t budgetViolations{0};
+  long double budgetFidelity{1.0L};
+
+  std::size_t maxFusionQubits{0};
+  std::size_t fusedGates{0};
+  std::size_t unfusedGates{0};
+
+  // state of the currently pending fused block
+  dd::mEdge fusedOperation{};
+  std::set<qc::Qubit> fusedQubits;
+  std::size_t fusedOperationCount{0};
+
   struct CircuitAnalysis {
     bool isDynamic = false;
     bool hasMeasurements = false;
@@ -123,10 +261,56 @@ protected:
 
   CircuitAnalysis analyseCircuit();
 
+  std::map<std::string, std::size_t> simulateShotsInParallel(std::size_t shots);
+  std::map<std::string, std::size_t>
+  simulateByMeasurementBranching(std::size_t shots);
+  std::map<std::string, dd::fp>
+  branchOnOutcomes(std::size_t opIdx, std::size_t targetIdx, dd::vEdge state,
+                   std::map<std::size_t, bool> classicValues,
+                   dd::fp pathProbability);
+  static bool
+  isClassicConditionSatisfied(const std::unique_ptr<qc::Operation>& op,
+                              std::map<std::size_t, bool>& classicValues);
+  [[nodiscard]] std::string
+  toClassicalRegisterString(const std::map<std::size_t, bool>& values) const;
+
   virtual std::map<std::size_t, bool> singleShot(bool ignoreNonUnitaries);
   virtual void initializeSimulation(std::size_t nQubits);
   virtual char measure(dd::Qubit i);
 
   virtual void reset(qc::NonUnitaryOperation* nonUnitaryOp);
   virtual void applyOperationToState(std::unique_ptr<qc::Operation>& op);
+
+  [[nodiscard]] std::size_t estimateMemoryUsage() const;
+  void enforceMemoryBudget();
+
+  // the prefix is only shared between shots if it is not modified by
+  // approximation and if the state is the vector DD of the base simulator
+  [[nodiscard]] virtual bool supportsPrefixCaching() const {
+    return prefixCaching && (approximationInfo.stepFidelity >= 1.0 ||
+                             approximationInfo.stepNumber == 0);
+  }
+  // branching keeps many states alive at once and is not subject to the
+  // memory budget
+  [[nodiscard]] virtual bool supportsMeasurementBranching() const {
+    return measurementBranching && memoryBudget == 0 &&
+           (approximationInfo.stepFidelity >= 1.0 ||
+            approximationInfo.stepNumber == 0);
+  }
+  // parallel shots run on copies of the base simulator, so derived simulators
+  // with custom state handling have to opt out; each copy owns a package, so a
+  // memory budget could not be enforced globally
+  [[nodiscard]] virtual bool supportsParallelShots() const {
+    return memoryBudget == 0;
+  }
+  // the budget is enforced on the vector DD of the base simulator
+  [[nodiscard]] virtual bool supportsMemoryBudget() const { return true; }
+  // gate fusion is only sound if gates are applied to the state without any
+  // per-gate side effects (e.g., noise or approximation)
+  [[nodiscard]] virtual bool supportsGateFusion() const {
+    return maxFusionQubits > 0 && (approximationInfo.stepFidelity >= 1.0 ||
+                                   approximationInfo.stepNumber == 0);
+  }
+  void fuseOperation(const std::unique_ptr<qc::Operation>& op);
+  void applyFusedOperation();
 };
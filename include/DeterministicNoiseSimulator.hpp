@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CircuitSimulator.hpp"
+#include "PackedBitString.hpp"
 #include "Simulator.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
@@ -75,8 +76,7 @@ public:
         noiseProbability_, ampDampingProbSingleQubit, multiQubitGateFactor_);
   }
 
-  std::map<std::string, std::size_t>
-  measureAllNonCollapsing(std::size_t shots) override {
+  PackedHistogram measureAllNonCollapsingCompact(std::size_t shots) override {
     return sampleFromProbabilityMap(
         rootEdge.getSparseProbabilityVectorStrKeys(getNumberOfQubits(),
                                                    measurementThreshold),
@@ -88,10 +88,19 @@ public:
   void reset(qc::NonUnitaryOperation* nonUnitaryOp) override;
   void applyOperationToState(std::unique_ptr<qc::Operation>& op) override;
 
-  std::map<std::string, std::size_t>
+  PackedHistogram
   sampleFromProbabilityMap(const dd::SparsePVecStrKeys& resultProbabilityMap,
                            std::size_t shots);
 
+  // noise effects have to be applied after every individual gate
+  [[nodiscard]] bool supportsGateFusion() const override { return false; }
+  [[nodiscard]] bool supportsParallelShots() const override { return false; }
+  [[nodiscard]] bool supportsPrefixCaching() const override { return false; }
+  [[nodiscard]] bool supportsMeasurementBranching() const override {
+    return false;
+  }
+  [[nodiscard]] bool supportsMemoryBudget() const override { return false; }
+
   [[nodiscard]] std::size_t getActiveNodeCount() const override {
     return Simulator::dd->template getUniqueTable<dd::dNode>()
         .getNumActiveEntries();
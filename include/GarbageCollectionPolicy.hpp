@@ -0,0 +1,212 @@
+#pragma once
+
+#include "dd/Node.hpp"
+#include "dd/Package.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * Decides after which operations the unique tables of a DD package are
+ * garbage collected. Collecting after every operation keeps the memory
+ * footprint minimal, but every collection also invalidates compute table
+ * entries that might still be useful. The policy is queried via
+ * `maybeCollect` at every point where a simulator used to collect
+ * unconditionally.
+ */
+class GarbageCollectionPolicy {
+public:
+  enum class Strategy : std::uint8_t {
+    EveryOperation,
+    EveryKOperations,
+    NodeThreshold,
+    BytesThreshold,
+    Adaptive
+  };
+
+  GarbageCollectionPolicy() = default;
+
+  /**
+   * Let the package decide after every operation (the historic behavior).
+   */
+  static GarbageCollectionPolicy everyOperation() {
+    return GarbageCollectionPolicy{Strategy::EveryOperation, 1};
+  }
+  /**
+   * Only consider collecting after every `k`-th operation.
+   */
+  static GarbageCollectionPolicy everyKOperations(const std::size_t k) {
+    return GarbageCollectionPolicy{Strategy::EveryKOperations,
+                                   std::max<std::size_t>(k, 1)};
+  }
+  /**
+   * Collect as soon as the unique tables hold at least `nodes` nodes more than
+   * after the previous collection.
+   */
+  static GarbageCollectionPolicy nodeThreshold(const std::size_t nodes) {
+    return GarbageCollectionPolicy{Strategy::NodeThreshold, nodes};
+  }
+  /**
+   * Collect as soon as the nodes in the unique tables occupy at least `bytes`
+   * bytes more than after the previous collection.
+   */
+  static GarbageCollectionPolicy bytesThreshold(const std::size_t bytes) {
+    return GarbageCollectionPolicy{Strategy::BytesThreshold, bytes};
+  }
+  /**
+   * Adapt the number of operations between two collections to how much the
+   * recent collections actually freed. The interval doubles after every
+   * collection that did not free any node and halves otherwise.
+   * The feedback deliberately is the outcome of the collections rather than
+   * the compute-table hit rate: the hit rate mostly depends on how repetitive
+   * the circuit is and drops for reasons unrelated to collecting, whereas a
+   * collection that freed nothing is exactly the case in which the cleared
+   * compute-table entries were given up for no benefit.
+   * @param maxInterval upper bound for the interval between two collections
+   */
+  static GarbageCollectionPolicy adaptive(const std::size_t maxInterval = 64) {
+    return GarbageCollectionPolicy{Strategy::Adaptive,
+                                   std::max<std::size_t>(maxInterval, 1)};
+  }
+
+  /**
+   * Create a policy with the same configuration but without any state. This
+   * is used to hand out independent policies to multiple DD packages.
+   */
+  [[nodiscard]] GarbageCollectionPolicy clone() const {
+    return GarbageCollectionPolicy{strategy, parameter};
+  }
+
+  /**
+   * Notify the policy that an operation has been applied and collect garbage
+   * if the policy demands it.
+   * @return whether the package actually collected any garbage
+   */
+  template <class Config> bool maybeCollect(dd::Package<Config>& dd) {
+    ++operationsSinceCollection;
+
+    bool run = false;
+    bool force = false;
+    switch (strategy) {
+    case Strategy::EveryOperation:
+      // the package would return right away, so spare the bookkeeping
+      run = possiblyNeedsCollection(dd);
+      break;
+    case Strategy::EveryKOperations:
+      run = operationsSinceCollection >= parameter;
+      break;
+    case Strategy::NodeThreshold:
+      run = force = countNodes(dd) >= limit;
+      break;
+    case Strategy::BytesThreshold:
+      run = force = countBytes(dd) >= limit;
+      break;
+    case Strategy::Adaptive:
+      run = operationsSinceCollection >= interval;
+      break;
+    }
+    if (!run) {
+      ++skipped;
+      return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto nodesBefore = countNodes(dd);
+    const auto collected = dd.garbageCollect(force);
+    const auto nodesAfter = countNodes(dd);
+    time += std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          start)
+                .count();
+
+    ++runs;
+    const auto freed = nodesBefore > nodesAfter;
+    if (freed) {
+      ++effectiveRuns;
+    }
+    operationsSinceCollection = 0;
+    switch (strategy) {
+    case Strategy::NodeThreshold:
+      // only collect again once `parameter` new nodes have been created, since
+      // every forced collection also clears the compute tables
+      limit = nodesAfter + parameter;
+      break;
+    case Strategy::BytesThreshold:
+      limit = countBytes(dd) + parameter;
+      break;
+    case Strategy::Adaptive:
+      interval = freed ? std::max<std::size_t>(interval / 2, 1)
+                       : std::min(interval * 2, parameter);
+      break;
+    default:
+      break;
+    }
+    return collected;
+  }
+
+  void mergeStatistics(const GarbageCollectionPolicy& other) {
+    runs += other.runs;
+    effectiveRuns += other.effectiveRuns;
+    skipped += other.skipped;
+    time += other.time;
+  }
+
+  [[nodiscard]] std::map<std::string, std::string> statistics() const {
+    return {
+        {"gc_runs", std::to_string(runs)},
+        {"gc_effective_runs", std::to_string(effectiveRuns)},
+        {"gc_skipped", std::to_string(skipped)},
+        {"gc_time", std::to_string(time)},
+    };
+  }
+
+  [[nodiscard]] Strategy getStrategy() const { return strategy; }
+  [[nodiscard]] std::size_t getParameter() const { return parameter; }
+  [[nodiscard]] std::size_t getRuns() const { return runs; }
+  [[nodiscard]] double getTime() const { return time; }
+
+private:
+  GarbageCollectionPolicy(const Strategy strategy_,
+                          const std::size_t parameter_)
+      : strategy(strategy_), parameter(parameter_), limit(parameter_) {}
+
+  template <class Config>
+  static bool possiblyNeedsCollection(dd::Package<Config>& dd) {
+    return dd.template getUniqueTable<dd::vNode>().possiblyNeedsCollection() ||
+           dd.template getUniqueTable<dd::mNode>().possiblyNeedsCollection() ||
+           dd.template getUniqueTable<dd::dNode>().possiblyNeedsCollection() ||
+           dd.cUniqueTable.possiblyNeedsCollection();
+  }
+
+  template <class Config>
+  static std::size_t countNodes(dd::Package<Config>& dd) {
+    return dd.template getUniqueTable<dd::vNode>().getNumEntries() +
+           dd.template getUniqueTable<dd::mNode>().getNumEntries() +
+           dd.template getUniqueTable<dd::dNode>().getNumEntries();
+  }
+  template <class Config>
+  static std::size_t countBytes(dd::Package<Config>& dd) {
+    return (dd.template getUniqueTable<dd::vNode>().getNumEntries() *
+            sizeof(dd::vNode)) +
+           (dd.template getUniqueTable<dd::mNode>().getNumEntries() *
+            sizeof(dd::mNode)) +
+           (dd.template getUniqueTable<dd::dNode>().getNumEntries() *
+            sizeof(dd::dNode));
+  }
+
+  Strategy strategy = Strategy::EveryOperation;
+  std::size_t parameter = 1;
+
+  std::size_t operationsSinceCollection = 0;
+  std::size_t interval = 1;
+  // node or byte count at which the threshold strategies collect next
+  std::size_t limit = 1;
+
+  std::size_t runs = 0;
+  std::size_t effectiveRuns = 0;
+  std::size_t skipped = 0;
+  double time = 0.;
+};
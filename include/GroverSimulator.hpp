@@ -41,10 +41,12 @@ public:
   std::map<std::string, std::size_t> simulate(std::size_t shots) override;
 
   std::map<std::string, std::string> additionalStatistics() override {
-    return {
+    auto statistics = Simulator<Config>::gcPolicy.statistics();
+    statistics.insert({
         {"oracle", std::string(oracle.rbegin(), oracle.rend())},
         {"iterations", std::to_string(iterations)},
-    };
+    });
+    return statistics;
   }
 
   static std::uint64_t calculateIterations(const qc::Qubit nQubits) {
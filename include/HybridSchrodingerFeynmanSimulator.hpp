@@ -2,22 +2,36 @@
 
 #include "CircuitSimulator.hpp"
 #include "Definitions.hpp"
+#include "PackedBitString.hpp"
+#include "WorkerPool.hpp"
 #include "circuit_optimizer/CircuitOptimizer.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
 #include "dd/Package.hpp"
 #include "dd/Package_fwd.hpp"
 #include "ir/QuantumComputation.hpp"
+#include "ir/operations/Control.hpp"
+#include "ir/operations/OpType.hpp"
 #include "ir/operations/Operation.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <complex>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 template <class Config = dd::DDPackageConfig>
 class HybridSchrodingerFeynmanSimulator : public CircuitSimulator<Config> {
@@ -55,6 +69,7 @@ public:
   }
 
   std::map<std::string, std::size_t> simulate(std::size_t shots) override;
+  PackedHistogram simulateCompact(std::size_t shots) override;
 
   Mode mode = Mode::Amplitude;
 
@@ -70,12 +85,182 @@ public:
     return CircuitSimulator<Config>::getVector();
   }
 
+  /**
+   * Compute the amplitudes of the given basis states only. For each decision
+   * path, the amplitude of a basis state is the product of the slices'
+   * amplitudes, which is obtained by following a single path through every
+   * slice's DD. Hence, neither the combined DD of a path nor the full state
+   * vector is ever constructed, which allows querying amplitudes of circuits
+   * too large for a dense state vector (e.g., for cross-entropy benchmarking).
+   * @param bitstrings the basis states (q_n-1 ... q_0) to compute
+   * @return the amplitudes in the order of the given basis states
+   */
+  std::vector<std::complex<dd::fp>>
+  getAmplitudes(const std::vector<std::string>& bitstrings);
+
   //  Get # of decisions for given split_qubit, so that lower slice: q0 < i <
   //  qubit; upper slice: qubit <= i < nqubits
   std::size_t getNDecisions(qc::Qubit splitQubit);
+  // Get # of decisions for multiple cuts, each split qubit being the lowest
+  // qubit of a slice
+  std::size_t getNDecisions(const std::vector<qc::Qubit>& splitQubits);
 
   [[nodiscard]] Mode getMode() const { return mode; }
 
+  /**
+   * Let the simulator choose the split qubit via `planSplitQubit` instead of
+   * always cutting the circuit in the middle.
+   */
+  void setAutomaticSplit(const bool enable) { automaticSplit = enable; }
+  [[nodiscard]] bool getAutomaticSplit() const { return automaticSplit; }
+
+  /**
+   * Determine the split qubit with the lowest estimated total work, i.e., the
+   * number of decision paths times the estimated cost of simulating both
+   * slices of a single path. Cuts through gates that cannot be cut are
+   * skipped.
+   */
+  [[nodiscard]] qc::Qubit planSplitQubit();
+
+  /**
+   * Cut the circuit at multiple qubits, resulting in one slice more than the
+   * number of cuts. Each split qubit is the lowest qubit of a slice, and every
+   * gate crossing a cut contributes its own decision. The slices of each path
+   * are combined using chained Kronecker products. An empty list restores the
+   * single cut.
+   * @param splitQubits_ the split qubits (between 1 and nqubits - 1)
+   */
+  void setSplitQubits(std::vector<qc::Qubit> splitQubits_) {
+    std::sort(splitQubits_.begin(), splitQubits_.end());
+    splitQubits_.erase(std::unique(splitQubits_.begin(), splitQubits_.end()),
+                       splitQubits_.end());
+    const auto nqubits = CircuitSimulator<Config>::getNumberOfQubits();
+    if (!splitQubits_.empty() &&
+        (splitQubits_.front() == 0 || splitQubits_.back() >= nqubits)) {
+      throw std::invalid_argument(
+          "Split qubits must be between 1 and the number of qubits - 1.");
+    }
+    splitQubits = std::move(splitQubits_);
+  }
+  [[nodiscard]] const std::vector<qc::Qubit>& getSplitQubits() const {
+    return splitQubits;
+  }
+
+  // (lowest) split qubit used in the last simulation
+  [[nodiscard]] qc::Qubit getSplitQubit() const {
+    return usedSplitQubits.empty() ? 0 : usedSplitQubits.front();
+  }
+
+  /**
+   * Traverse the tree of decisions instead of simulating every path from
+   * scratch. At each cut gate, the states of the slices are kept as a
+   * checkpoint and the paths taking the other decision later continue from
+   * there, so operations in front of a decision are only applied once for all
+   * paths sharing them.
+   */
+  void setPrefixSharing(const bool enable) { prefixSharing = enable; }
+  [[nodiscard]] bool getPrefixSharing() const { return prefixSharing; }
+
+  /**
+   * Set the maximum number of checkpoints a thread keeps at the same time when
+   * prefix sharing is enabled. Once the limit is reached, the paths branching
+   * off are replayed from the beginning of the circuit instead.
+   * @param maxCheckpoints_ maximum number of checkpoints per thread
+   */
+  void setMaxCheckpoints(const std::size_t maxCheckpoints_) {
+    maxCheckpoints = maxCheckpoints_;
+  }
+  [[nodiscard]] std::size_t getMaxCheckpoints() const {
+    return maxCheckpoints;
+  }
+
+  /**
+   * Set the number of nodes the partial results of the DD mode may occupy in
+   * memory during the reduction. Partial results exceeding this threshold are
+   * spilled to the scratch directory until they are needed again. Since every
+   * partial result kept in memory occupies its own package, setting a
+   * threshold also limits the resident partial results to one per thread.
+   * @param nodes maximum number of nodes kept in memory (unlimited by default)
+   */
+  void setSpillThreshold(const std::size_t nodes) { spillThreshold = nodes; }
+  [[nodiscard]] std::size_t getSpillThreshold() const {
+    return spillThreshold;
+  }
+
+  /**
+   * Set the directory in which spilled partial results are stored. Every
+   * simulation creates its own uniquely named subdirectory, which is removed
+   * once the simulation is finished. Defaults to the system's temporary
+   * directory.
+   */
+  void setScratchDirectory(std::string directory) {
+    scratchDirectory = std::move(directory);
+  }
+  [[nodiscard]] const std::string& getScratchDirectory() const {
+    return scratchDirectory;
+  }
+
+  // number of partial results spilled to disk in the last simulation
+  [[nodiscard]] std::size_t getSpilledResults() const {
+    return spilledResults;
+  }
+
+  /**
+   * Accumulate the results of the amplitude mode in a single buffer instead
+   * of one buffer per chunk of paths that are summed up at the end. The
+   * buffer is split into stripes by the highest qubits, and every worker adds
+   * its results stripe by stripe while holding the lock of the stripe. This
+   * reduces the peak memory from one state vector per thread to about a
+   * single state vector (per process if worker processes are used).
+   */
+  void setSingleAmplitudeBuffer(const bool enable) {
+    singleAmplitudeBuffer = enable;
+  }
+  [[nodiscard]] bool getSingleAmplitudeBuffer() const {
+    return singleAmplitudeBuffer;
+  }
+
+  /**
+   * Distribute the decision paths over local worker processes. The simulator
+   * acts as the coordinator that hands out ranges of paths to the workers
+   * whenever they have finished their previous range. Each worker splits its
+   * ranges over the configured number of threads and accumulates its paths in
+   * an amplitude vector or a DD, which is sent back once all paths are done
+   * and reduced by the coordinator.
+   * Only supported on POSIX systems.
+   * @param nprocesses_ number of worker processes (1 keeps the simulation
+   * within this process)
+   */
+  void setNumberOfProcesses(const std::size_t nprocesses_) {
+    if (nprocesses_ > 1 && !WorkerPool::isSupported()) {
+      throw std::runtime_error(
+          "Worker processes are not supported on this platform.");
+    }
+    nprocesses = std::max<std::size_t>(nprocesses_, 1);
+  }
+  [[nodiscard]] std::size_t getNumberOfProcesses() const { return nprocesses; }
+
+  // number of operations applied to the slices in the last simulation
+  [[nodiscard]] std::size_t getAppliedOperations() const {
+    return appliedOperations;
+  }
+
+  std::map<std::string, std::string> additionalStatistics() override {
+    auto statistics = CircuitSimulator<Config>::additionalStatistics();
+    statistics.insert({"split_qubit", std::to_string(getSplitQubit())});
+    statistics.insert(
+        {"slices", std::to_string(usedSplitQubits.size() + 1)});
+    statistics.insert({"decisions", std::to_string(usedDecisions)});
+    statistics.insert({"processes", std::to_string(nprocesses)});
+    statistics.insert(
+        {"applied_operations", std::to_string(getAppliedOperations())});
+    if (mode == Mode::DD) {
+      statistics.insert(
+          {"spilled_results", std::to_string(getSpilledResults())});
+    }
+    return statistics;
+  }
+
 protected:
   /// See Simulator<Config>::exportDDtoGraphviz
   void exportDDtoGraphviz(std::ostream& os, bool colored, bool edgeLabels,
@@ -84,51 +269,187 @@ protected:
 
 private:
   std::size_t nthreads = 2;
+  std::size_t nprocesses = 1;
   dd::CVec finalAmplitudes;
+  bool automaticSplit = false;
+  std::vector<qc::Qubit> splitQubits;
+  std::vector<qc::Qubit> usedSplitQubits;
+  std::size_t usedDecisions = 0;
+  bool prefixSharing = false;
+  bool singleAmplitudeBuffer = false;
+  std::size_t maxCheckpoints = 16;
+  std::atomic<std::size_t> appliedOperations{0};
+  std::size_t spillThreshold = std::numeric_limits<std::size_t>::max();
+  std::string scratchDirectory;
+  std::atomic<std::size_t> spilledResults{0};
+  // nodes of the partial results currently kept in memory
+  std::atomic<std::size_t> residentNodes{0};
+  // partial results (and thus packages) currently kept in memory
+  std::atomic<std::size_t> residentPartials{0};
+  std::size_t maxResidentPartials = std::numeric_limits<std::size_t>::max();
+  // job-unique directory holding the spilled results (created on demand)
+  std::string scratchPath;
+  std::size_t scratchFiles = 0;
+  std::mutex scratchMutex;
+  // guards merging the garbage collection statistics of concurrent slices
+  std::mutex gcStatisticsMutex;
 
-  void simulateHybridTaskflow(qc::Qubit splitQubit);
-  void simulateHybridAmplitudes(qc::Qubit splitQubit);
+  // estimated cost of simulating the slice [start, end] for a single path
+  [[nodiscard]] double estimateSliceCost(qc::Qubit start, qc::Qubit end) const;
 
-  qc::VectorDD simulateSlicing(std::unique_ptr<dd::Package<Config>>& sliceDD,
-                               qc::Qubit splitQubit, std::size_t controls);
+  void checkSupportedCircuit() const;
+  // the cuts of the next simulation, which also resets the statistics
+  std::vector<qc::Qubit> prepareCuts();
 
-  class Slice {
-  protected:
-    qc::Qubit nextControlIdx = 0;
+  void simulateHybridTaskflow(const std::vector<qc::Qubit>& splitQubits);
 
-    std::size_t getNextControl() {
-      std::size_t idx = 1UL << nextControlIdx;
-      nextControlIdx++;
-      return controls & idx;
-    }
+  // sum of a range of paths in the DD mode, living in its own package or, if
+  // spilled, in a file in the scratch directory
+  struct PartialResult {
+    std::unique_ptr<dd::Package<Config>> package;
+    qc::VectorDD edge{};
+    std::size_t nodes = 0;
+    bool resident = false;
+    std::string file;
+  };
+  void keepOrSpill(PartialResult& partial);
+  void restore(PartialResult& partial);
+  void release(PartialResult& partial);
+  void reducePartials(PartialResult& left, PartialResult& right);
+  std::string nextScratchFile();
+  void removeScratchDirectory();
+  void simulateHybridAmplitudes(const std::vector<qc::Qubit>& splitQubits);
+  void simulateDistributed(const std::vector<qc::Qubit>& splitQubits);
+  void addToSharedAmplitudes(const qc::VectorDD& result,
+                             std::vector<std::mutex>& stripes,
+                             std::size_t worker);
+
+  // number of controls of the operation lying in a different slice than its
+  // targets, i.e., the number of decisions it contributes if it is cut at its
+  // controls
+  static std::size_t
+  countCutControls(const qc::Operation& op,
+                   const std::vector<qc::Qubit>& splitQubits);
+
+  // operator Schmidt decomposition of a gate acting on two slices, i.e.,
+  // U = sum_k lower[k] (x) upper[k], where each term is one decision branch
+  struct CutDecomposition {
+    std::vector<qc::Qubit> lowerQubits;
+    std::vector<qc::Qubit> upperQubits;
+    std::vector<dd::CMat> lower;
+    std::vector<dd::CMat> upper;
+    // number of decision bits selecting the term
+    std::size_t bits = 0;
+  };
+  // the qubits of the gate in the lower and in the upper slice if it is cut
+  // via its Schmidt decomposition or std::nullopt if the gate is not cut or
+  // can be cut at its single control in the other slice
+  static std::optional<
+      std::pair<std::vector<qc::Qubit>, std::vector<qc::Qubit>>>
+  cutOperands(const qc::Operation& op,
+              const std::vector<qc::Qubit>& splitQubits);
+  // packages for decomposing gates, one per number of qubits of the gate
+  using DecompositionPackages =
+      std::map<std::size_t, std::unique_ptr<dd::Package<Config>>>;
+  // the decomposition of a cut gate (without its qubits). Gates acting alike
+  // on the cut, i.e., with the same type, parameters, and operands relative
+  // to the cut, share their decomposition, which is only computed once.
+  const CutDecomposition&
+  decomposeCut(const qc::Operation& op,
+               const std::vector<qc::Qubit>& lowerQubits,
+               const std::vector<qc::Qubit>& upperQubits,
+               DecompositionPackages& packages);
+  // number of decisions of all operations for the given cuts
+  std::size_t countDecisions(const std::vector<qc::Qubit>& splitQubits,
+                             DecompositionPackages& packages);
+  // type, parameters, local controls, local targets, and number of qubits in
+  // the lower slice of a cut gate
+  using CutKey = std::tuple<qc::OpType, std::vector<dd::fp>, qc::Controls,
+                            qc::Targets, std::size_t>;
+  std::map<CutKey, CutDecomposition> decompositionCache;
+  // decompositions of the cut gates of the current simulation
+  std::unordered_map<const qc::Operation*, CutDecomposition> cutDecompositions;
+  // DDs of the terms of the cut gates in a single slice package, which are
+  // built on first use and stay referenced until `releaseTermDDs` is called
+  using TermDDs =
+      std::unordered_map<const CutDecomposition*,
+                         std::vector<std::optional<
+                             std::pair<qc::MatrixDD, qc::MatrixDD>>>>;
+  static void releaseTermDDs(std::unique_ptr<dd::Package<Config>>& sliceDD,
+                             TermDDs& termDDs);
+
+  qc::VectorDD simulateSlicing(std::unique_ptr<dd::Package<Config>>& sliceDD,
+                               TermDDs& termDDs,
+                               const std::vector<qc::Qubit>& splitQubits,
+                               std::size_t controls);
+  // simulate the paths with the given control values by traversing the tree
+  // of decisions and pass each path's (referenced) result to `onPath`
+  void simulateDecisionTree(
+      std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+      const std::vector<qc::Qubit>& splitQubits,
+      std::vector<std::size_t> controls,
+      const std::function<void(const qc::VectorDD&)>& onPath);
+  // number of decision bits the operation consumes
+  [[nodiscard]] std::size_t
+  decisionBits(const qc::Operation& op,
+               const std::vector<qc::Qubit>& splitQubits) const;
 
+  class Slice {
   public:
     qc::Qubit start;
     qc::Qubit end;
-    std::size_t controls;
     qc::Qubit nqubits;
-    std::size_t nDecisionsExecuted = 0;
     qc::VectorDD edge{};
 
     explicit Slice(std::unique_ptr<dd::Package<Config>>& dd,
-                   const qc::Qubit start_, const qc::Qubit end_,
-                   const std::size_t controls_)
-        : start(start_), end(end_), controls(controls_),
-          nqubits(end - start + 1),
+                   const qc::Qubit start_, const qc::Qubit end_)
+        : start(start_), end(end_), nqubits(end - start + 1),
           edge(dd->makeZeroState(static_cast<dd::Qubit>(nqubits), start_)) {
       dd->incRef(edge);
     }
 
     explicit Slice(std::unique_ptr<dd::Package<Config>>& dd, qc::VectorDD edge_,
-                   const qc::Qubit start_, const qc::Qubit end_,
-                   const std::size_t controls_)
-        : start(start_), end(end_), controls(controls_),
-          nqubits(end - start + 1), edge(edge_) {
+                   const qc::Qubit start_, const qc::Qubit end_)
+        : start(start_), end(end_), nqubits(end - start + 1), edge(edge_) {
       dd->incRef(edge);
     }
 
-    // returns true if this operation was a split operation
+    // returns true if this operation was a split operation. `control` is the
+    // value of the decision bit assigned to the operation in case it is cut.
     bool apply(std::unique_ptr<dd::Package<Config>>& sliceDD,
-               const std::unique_ptr<qc::Operation>& op);
+               const std::unique_ptr<qc::Operation>& op, bool control);
   };
+
+  // slices starting from the zero state or, if given, from the edges
+  std::vector<Slice> makeSlices(std::unique_ptr<dd::Package<Config>>& sliceDD,
+                                const std::vector<qc::Qubit>& splitQubits,
+                                const std::vector<qc::VectorDD>& edges = {});
+  // the lowest bits of `controls` select the term of a cut operation.
+  // Returns the number of decision bits consumed by the operation.
+  std::size_t applyToSlices(std::unique_ptr<dd::Package<Config>>& sliceDD,
+                            TermDDs& termDDs, std::vector<Slice>& slices,
+                            const std::unique_ptr<qc::Operation>& op,
+                            std::size_t controls);
+  void applyCutTerm(std::unique_ptr<dd::Package<Config>>& sliceDD,
+                    TermDDs& termDDs, std::vector<Slice>& slices,
+                    const CutDecomposition& decomposition, std::size_t term);
+  // the matrix acting on the given qubits (least significant first)
+  static qc::MatrixDD
+  makeMatrixDD(std::unique_ptr<dd::Package<Config>>& sliceDD,
+               const dd::CMat& matrix, const std::vector<qc::Qubit>& qubits);
+  // simulate a single path and return its (referenced) slices
+  std::vector<Slice>
+  simulateSlices(std::unique_ptr<dd::Package<Config>>& sliceDD,
+                 TermDDs& termDDs, const std::vector<qc::Qubit>& splitQubits,
+                 std::size_t controls);
+  // like `simulateDecisionTree`, but pass the slices of each path instead of
+  // their combination
+  void traverseDecisionTree(
+      std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+      const std::vector<qc::Qubit>& splitQubits,
+      std::vector<std::size_t> controls,
+      const std::function<void(const std::vector<Slice>&)>& onSlices);
+  // combine the slices from the bottom up (the result is referenced)
+  qc::VectorDD combineSlices(std::unique_ptr<dd::Package<Config>>& sliceDD,
+                             const std::vector<Slice>& slices);
 };
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A measurement outcome packed into 64-bit words. Qubit `i` is stored in bit
+ * `i % 64` of word `i / 64`.
+ */
+using PackedBitString = std::vector<std::uint64_t>;
+
+struct PackedBitStringHash {
+  std::size_t operator()(const PackedBitString& bits) const noexcept {
+    std::size_t seed = bits.size();
+    for (const auto word : bits) {
+      // boost::hash_combine
+      seed ^= std::hash<std::uint64_t>{}(word) + 0x9e3779b97f4a7c15ULL +
+              (seed << 6U) + (seed >> 2U);
+    }
+    return seed;
+  }
+};
+
+using PackedHistogram =
+    std::unordered_map<PackedBitString, std::size_t, PackedBitStringHash>;
+
+[[nodiscard]] inline std::size_t packedWords(const std::size_t nqubits) {
+  return (nqubits + 63U) / 64U;
+}
+
+/**
+ * Convert a packed outcome to the usual string representation, where the
+ * first character corresponds to the most significant qubit.
+ */
+[[nodiscard]] inline std::string toBitString(const PackedBitString& bits,
+                                             const std::size_t nqubits) {
+  std::string result(nqubits, '0');
+  for (std::size_t q = 0; q < nqubits; ++q) {
+    if (((bits[q / 64U] >> (q % 64U)) & 1U) != 0U) {
+      result[nqubits - 1 - q] = '1';
+    }
+  }
+  return result;
+}
+
+/**
+ * Convert a string representation of an outcome, where the first character
+ * corresponds to the most significant bit, to its packed form.
+ */
+[[nodiscard]] inline PackedBitString fromBitString(const std::string& str) {
+  const auto nbits = str.size();
+  PackedBitString bits(packedWords(nbits), 0U);
+  for (std::size_t q = 0; q < nbits; ++q) {
+    if (str[nbits - 1 - q] == '1') {
+      bits[q / 64U] |= 1ULL << (q % 64U);
+    }
+  }
+  return bits;
+}
+
+/**
+ * Pack the index of a basis state, i.e., its integer representation.
+ */
+[[nodiscard]] inline PackedBitString fromIndex(const std::size_t index,
+                                               const std::size_t nbits) {
+  PackedBitString bits(packedWords(nbits), 0U);
+  if (!bits.empty()) {
+    bits.front() = static_cast<std::uint64_t>(index);
+  }
+  return bits;
+}
+
+[[nodiscard]] inline PackedHistogram
+toPackedHistogram(const std::map<std::string, std::size_t>& histogram) {
+  PackedHistogram result;
+  result.reserve(histogram.size());
+  for (const auto& [str, count] : histogram) {
+    result.emplace(fromBitString(str), count);
+  }
+  return result;
+}
+
+[[nodiscard]] inline std::map<std::string, std::size_t>
+toStringHistogram(const PackedHistogram& histogram, const std::size_t nbits) {
+  std::map<std::string, std::size_t> result;
+  for (const auto& [bits, count] : histogram) {
+    result.emplace(toBitString(bits, nbits), count);
+  }
+  return result;
+}
@@ -1,19 +1,27 @@
 #pragma once
 
 #include "CircuitSimulator.hpp"
+#include "GarbageCollectionPolicy.hpp"
+#include "PackedBitString.hpp"
+#include "SimulationPathCache.hpp"
 #include "Simulator.hpp"
 #include "circuit_optimizer/CircuitOptimizer.hpp"
 #include "dd/DDpackageConfig.hpp"
+#include "dd/Edge.hpp"
 #include "dd/Package_fwd.hpp"
 #include "ir/QuantumComputation.hpp"
+#include "ir/operations/Operation.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <nlohmann/json_fwd.hpp>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <taskflow/core/async.hpp> // IWYU pragma: keep
@@ -68,7 +76,9 @@ public:
       BracketGrouping,
       Alternating,
       Cotengra,
-      GateCost
+      GateCost,
+      CostModel,
+      Adaptive
     };
 
     // mode to use
@@ -83,6 +93,8 @@ public:
     std::list<std::size_t> gateCost;
     // random seed
     std::size_t seed;
+    // directory of the persistent simulation path cache (disabled if empty)
+    std::string pathCache{};
 
     // Add new variables here
     explicit Configuration(const Mode mode_ = Mode::Sequential,
@@ -112,6 +124,12 @@ public:
       if (mode == "gate_cost" || mode == "5") {
         return Mode::GateCost;
       }
+      if (mode == "cost_model" || mode == "6") {
+        return Mode::CostModel;
+      }
+      if (mode == "adaptive" || mode == "7") {
+        return Mode::Adaptive;
+      }
 
       throw std::invalid_argument("Invalid simulation path mode: " + mode);
     }
@@ -130,6 +148,10 @@ public:
         return "cotengra";
       case Mode::GateCost:
         return "gate_cost";
+      case Mode::CostModel:
+        return "cost_model";
+      case Mode::Adaptive:
+        return "adaptive";
       default:
         throw std::invalid_argument("Invalid simulation path mode");
       }
@@ -149,6 +171,9 @@ public:
       if (seed != 0) {
         conf["seed"] = seed;
       }
+      if (!pathCache.empty()) {
+        conf["path_cache"] = pathCache;
+      }
       return conf;
     }
 
@@ -174,6 +199,11 @@ public:
           (CircuitSimulator<Config>::qc->getNops()) / 2;
     }
 
+    // reuse a path stored for a circuit of the same structure
+    if (!configuration.pathCache.empty() && loadFromPathCache(configuration)) {
+      return;
+    }
+
     // Add new strategies here
     switch (configuration.mode) {
     case Configuration::Mode::BracketGrouping:
@@ -191,6 +221,13 @@ public:
       generateGatecostSimulationPath(configuration.startingPoint,
                                      configuration.gateCost);
       break;
+    case Configuration::Mode::CostModel:
+      generateCostModelSimulationPath();
+      break;
+    case Configuration::Mode::Adaptive:
+      // the path is decided during the simulation
+      adaptive = true;
+      break;
     default:
       generateSequentialSimulationPath();
       break;
@@ -206,14 +243,112 @@ public:
                                     std::move(gateCost_), seed_}) {}
 
   std::map<std::string, std::size_t> simulate(std::size_t shots) override;
+  PackedHistogram simulateCompact(std::size_t shots) override;
+
+  std::map<std::string, std::string> additionalStatistics() override {
+    auto statistics = CircuitSimulator<Config>::additionalStatistics();
+    if (memoryAwareScheduling) {
+      statistics.insert({"peak_live_nodes", std::to_string(peakLiveNodes)});
+    }
+    statistics.insert({"gate_cache_hits", std::to_string(gateCacheHits)});
+    statistics.insert({"gate_cache_misses", std::to_string(gateCacheMisses)});
+    if (adaptive) {
+      statistics.insert(
+          {"adaptive_matrix_vector_steps", std::to_string(adaptiveMxV)});
+      statistics.insert(
+          {"adaptive_matrix_matrix_steps", std::to_string(adaptiveMxM)});
+      statistics.insert(
+          {"adaptive_rejected_merges", std::to_string(adaptiveRejected)});
+    }
+    return statistics;
+  }
+
+  /**
+   * Set how much a matrix-matrix product may grow in the adaptive mode. A
+   * merge is rejected if the product has more nodes than `limit` times the
+   * nodes of both factors combined, or more nodes than the current state.
+   */
+  void setAdaptiveGrowthLimit(const double limit) {
+    adaptiveGrowthLimit = limit;
+  }
+  [[nodiscard]] double getAdaptiveGrowthLimit() const {
+    return adaptiveGrowthLimit;
+  }
 
+  /**
+   * In the adaptive mode, this returns the path that has been chosen during
+   * the last simulation, which can be replayed via `setSimulationPath`.
+   */
   const SimulationPath& getSimulationPath() const { return simulationPath; }
-  void setSimulationPath(const SimulationPath& path) { simulationPath = path; }
+  // setting a path explicitly disables the adaptive mode
+  void setSimulationPath(const SimulationPath& path) {
+    simulationPath = path;
+    adaptive = false;
+    storeInPathCache();
+  }
   void setSimulationPath(const typename SimulationPath::Components& components,
                          bool assumeCorrectOrder = false) {
+    adaptive = false;
     simulationPath =
         SimulationPath(CircuitSimulator<Config>::qc->getNops() + 1, components,
                        CircuitSimulator<Config>::qc.get(), assumeCorrectOrder);
+    storeInPathCache();
+  }
+
+  /**
+   * Whether the simulation path has been loaded from the path cache. If so,
+   * there is no need to determine a path externally (e.g., via cotengra).
+   */
+  [[nodiscard]] bool isSimulationPathCached() const { return pathFromCache; }
+
+  /**
+   * Set the number of threads used for executing the task graph. With more
+   * than one thread, every worker owns a separate DD package so that
+   * independent branches of the simulation path can be contracted
+   * concurrently. Intermediate results are transferred between the packages
+   * whenever the operands of a task live in different packages.
+   * @param nthreads_ number of threads (1 keeps the serial mode operating on
+   * the simulator's own package)
+   */
+  void setNumberOfThreads(const std::size_t nthreads_) {
+    nthreads = std::max<std::size_t>(nthreads_, 1);
+  }
+  [[nodiscard]] std::size_t getNumberOfThreads() const { return nthreads; }
+
+  /**
+   * Execute the simulation path in an order that keeps the number of live DD
+   * nodes small instead of the order chosen by the task graph. Among all
+   * ready tasks, the one freeing the most nodes of intermediate results is
+   * executed first, and the DDs of the operations are only constructed right
+   * before they are needed. This only affects the serial mode.
+   */
+  void setMemoryAwareScheduling(const bool enable) {
+    memoryAwareScheduling = enable;
+  }
+  [[nodiscard]] bool getMemoryAwareScheduling() const {
+    return memoryAwareScheduling;
+  }
+
+  /**
+   * Get the peak number of nodes of all intermediate results (including the
+   * operations' DDs) that have been alive at the same time. Only tracked with
+   * memory-aware scheduling, since determining the sizes requires traversing
+   * every result. Nodes shared between multiple results are counted once per
+   * result.
+   */
+  [[nodiscard]] std::size_t getPeakLiveNodes() const { return peakLiveNodes; }
+
+  /**
+   * Set the maximum number of distinct gate DDs that are cached during a run
+   * in the serial mode. Repeated gates, e.g., a CX on the same pair of qubits,
+   * then share a single DD instead of being constructed again.
+   * @param capacity maximum number of cached gates (0 disables the cache)
+   */
+  void setGateCacheCapacity(const std::size_t capacity) {
+    gateCacheCapacity = capacity;
+  }
+  [[nodiscard]] std::size_t getGateCacheCapacity() const {
+    return gateCacheCapacity;
   }
 
   // Add new strategies here
@@ -223,6 +358,14 @@ public:
   void generateAlternatingSimulationPath(std::size_t startingPoint);
   void generateGatecostSimulationPath(std::size_t startingPoint,
                                       std::list<std::size_t>& gateCosts);
+  /**
+   * Plan a path from a cost model of the circuit. Starting from the single
+   * operations, the pair of neighboring blocks with the lowest estimated
+   * multiplication cost is greedily contracted until only the final state is
+   * left. The size of a block's DD is estimated from the qubits it acts on
+   * and the number of entangling gates within it.
+   */
+  void generateCostModelSimulationPath();
 
 private:
   std::unordered_map<std::size_t, tf::Task> tasks;
@@ -233,7 +376,63 @@ private:
   tf::Executor executor;
   SimulationPath simulationPath{};
 
+  std::optional<SimulationPathCache> pathCache;
+  std::size_t pathCacheKey = 0;
+  bool pathFromCache = false;
+
+  std::size_t nthreads = 1;
+  bool adaptive = false;
+  double adaptiveGrowthLimit = 2.;
+  std::size_t adaptiveMxV = 0;
+  std::size_t adaptiveMxM = 0;
+  std::size_t adaptiveRejected = 0;
+
+  bool memoryAwareScheduling = false;
+  // number of nodes of each entry of `results` in the serial mode
+  std::unordered_map<std::size_t, std::size_t> resultSizes;
+  std::size_t liveNodes = 0;
+  std::size_t peakLiveNodes = 0;
+
+  // gate DDs of the current run keyed by the gate type, qubits, and parameters
+  using GateKey = std::vector<std::uint64_t>;
+  std::unordered_map<GateKey, qc::MatrixDD, PackedBitStringHash> gateCache;
+  std::size_t gateCacheCapacity = 256;
+  std::size_t gateCacheHits = 0;
+  std::size_t gateCacheMisses = 0;
+  // state of the parallel mode, every worker exclusively owns one package
+  std::vector<std::unique_ptr<dd::Package<Config>>> packages;
+  std::vector<GarbageCollectionPolicy> packageGcPolicies;
+  // package holding each entry of `results`
+  std::unordered_map<std::size_t, std::size_t> owners;
+  // results that have been transferred to another package and still have to
+  // be released by the worker owning them
+  std::vector<std::vector<std::variant<qc::VectorDD, qc::MatrixDD>>>
+      pendingReleases;
+  std::mutex resultsMutex;
+
+  bool loadFromPathCache(const Configuration& configuration);
+  void storeInPathCache();
+
   void constructTaskGraph();
   void addSimulationTask(std::size_t leftID, std::size_t rightID,
                          std::size_t resultID);
+  void materializeLeaf(std::size_t id);
+  qc::MatrixDD getGateDD(const qc::Operation& op);
+  void clearGateCache();
+  void contract(std::size_t leftID, std::size_t rightID, std::size_t resultID);
+  // record the size of a result if memory-aware scheduling is enabled
+  template <class Node>
+  void trackResult(std::size_t id, const dd::Edge<Node>& result);
+  void releaseResult(std::size_t id);
+  void runMemoryAwareSchedule();
+
+  void simulateParallel();
+  void simulateAdaptive();
+  void constructParallelTaskGraph(tf::Executor& parallelExecutor);
+  void addParallelSimulationTask(tf::Executor& parallelExecutor,
+                                 std::size_t leftID, std::size_t rightID,
+                                 std::size_t resultID);
+  std::variant<qc::VectorDD, qc::MatrixDD> fetchOperand(std::size_t id,
+                                                        std::size_t worker);
+  void releasePending(std::size_t worker);
 };
@@ -120,10 +120,12 @@ public:
   std::pair<std::uint32_t, std::uint32_t> getFactors() { return simFactors; }
 
   std::map<std::string, std::string> additionalStatistics() override {
-    return {{"composite_number", std::to_string(compositeN)},
-            {"coprime_a", std::to_string(coprimeA)},
-            {"sim_result", simResult},
-            {"sim_factor1", std::to_string(simFactors.first)},
-            {"sim_factor2", std::to_string(simFactors.second)}};
+    auto statistics = Simulator<Config>::gcPolicy.statistics();
+    statistics.insert({{"composite_number", std::to_string(compositeN)},
+                       {"coprime_a", std::to_string(coprimeA)},
+                       {"sim_result", simResult},
+                       {"sim_factor1", std::to_string(simFactors.first)},
+                       {"sim_factor2", std::to_string(simFactors.second)}});
+    return statistics;
   }
 };
@@ -144,7 +144,8 @@ public:
   std::pair<std::uint32_t, std::uint32_t> getFactors() { return simFactors; }
 
   std::map<std::string, std::string> additionalStatistics() override {
-    return {
+    auto statistics = Simulator<Config>::gcPolicy.statistics();
+    statistics.insert({
         {"composite_number", std::to_string(compositeN)},
         {"coprime_a", std::to_string(coprimeA)},
         {"emulation", "true"},
@@ -157,6 +158,7 @@ public:
         {"approximation_runs", std::to_string(approximationRuns)},
         {"step_fidelity", std::to_string(stepFidelity)},
         {"final_fidelity", std::to_string(finalFidelity)},
-    };
+    });
+    return statistics;
   }
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ir/QuantumComputation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A persistent cache for simulation paths. Every path is stored in a compact
+ * binary file inside the cache directory whose name is derived from a key.
+ * Keys are built from the structural hash of a circuit, so circuits that only
+ * differ in their gate parameters share the same entry.
+ */
+class SimulationPathCache {
+public:
+  using Components = std::vector<std::pair<std::size_t, std::size_t>>;
+
+  explicit SimulationPathCache(std::string directory_);
+
+  /**
+   * Hash the structure of a circuit, i.e., the number of qubits and the type,
+   * targets, and controls of all operations. Parameter values are ignored.
+   */
+  [[nodiscard]] static std::size_t
+  structuralHash(const qc::QuantumComputation& qc);
+
+  /**
+   * Build the key for the path of a circuit.
+   * @param qc the circuit
+   * @param strategy description of how the path has been generated, e.g.,
+   * the strategy and its settings
+   */
+  [[nodiscard]] static std::size_t key(const qc::QuantumComputation& qc,
+                                       const std::string& strategy);
+
+  /**
+   * Look up the path stored for the given key.
+   * @param key the key of the path
+   * @param nleaves the number of leaves (operations + initial state) the path
+   * has to cover
+   * @return the stored path or std::nullopt if there is no matching entry
+   */
+  [[nodiscard]] std::optional<Components> lookup(std::size_t key,
+                                                 std::size_t nleaves) const;
+
+  /**
+   * Store a path for the given key, replacing any previous entry.
+   */
+  void store(std::size_t key, std::size_t nleaves,
+             const Components& components) const;
+
+  [[nodiscard]] const std::string& getDirectory() const { return directory; }
+
+private:
+  [[nodiscard]] std::string filename(std::size_t key) const;
+
+  static constexpr std::uint32_t MAGIC = 0x50534444; // "DDSP"
+  static constexpr std::uint32_t VERSION = 1;
+
+  std::string directory;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "GarbageCollectionPolicy.hpp"
+#include "PackedBitString.hpp"
+#include "VectorDDSampler.hpp"
 #include "dd/ComplexValue.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
@@ -52,22 +55,62 @@ public:
    */
   virtual std::map<std::string, std::size_t> simulate(std::size_t shots) = 0;
 
+  /**
+   * Run the simulation in the (derived) class and return the result keyed by
+   * packed bit strings. This avoids allocating a string per distinct outcome.
+   * @param shots number of shots to take from the final quantum state
+   * @return a map from the packed basis states to the number of times they
+   * have been measured
+   */
+  virtual PackedHistogram simulateCompact(const std::size_t shots) {
+    return toPackedHistogram(simulate(shots));
+  }
+
   virtual std::map<std::string, std::string> additionalStatistics() {
     return {};
   };
 
+  /**
+   * Set the number of threads used for drawing samples from the final state.
+   * Shots are sampled in fixed-size chunks with their own random seeds so that
+   * the result for a fixed seed does not depend on the number of threads.
+   * @param nthreads number of threads (0 keeps the serial sampling mode)
+   */
+  void setSamplingThreads(const std::size_t nthreads) {
+    samplingThreads = nthreads;
+  }
+  [[nodiscard]] std::size_t getSamplingThreads() const {
+    return samplingThreads;
+  }
+
+  /**
+   * Set the policy deciding when the DD package is garbage collected during
+   * the simulation. Simulators that use multiple DD packages give each
+   * package an independent copy of the policy.
+   */
+  void setGarbageCollectionPolicy(const GarbageCollectionPolicy& policy) {
+    gcPolicy = policy.clone();
+  }
+  [[nodiscard]] const GarbageCollectionPolicy&
+  getGarbageCollectionPolicy() const {
+    return gcPolicy;
+  }
+
   std::string measureAll(bool collapse = false) {
     return dd->measureAll(rootEdge, collapse, mt, epsilon);
   }
 
   virtual std::map<std::string, std::size_t>
-  measureAllNonCollapsing(std::size_t shots) {
-    std::map<std::string, std::size_t> results;
-    for (std::size_t i = 0; i < shots; i++) {
-      const auto m = measureAll(false);
-      results[m]++;
-    }
-    return results;
+  measureAllNonCollapsing(const std::size_t shots) {
+    return toStringHistogram(measureAllNonCollapsingCompact(shots),
+                             getNumberOfQubits());
+  }
+
+  virtual PackedHistogram
+  measureAllNonCollapsingCompact(const std::size_t shots) {
+    const VectorDDSampler sampler(rootEdge, getNumberOfQubits());
+    return samplingThreads > 0 ? sampler.sample(shots, mt, samplingThreads)
+                               : sampler.sample(shots, mt);
   }
 
   char measureOneCollapsing(const dd::Qubit index,
@@ -77,8 +120,17 @@ public:
         rootEdge, index, assumeProbabilityNormalization, mt, epsilon);
   }
 
+  /**
+   * Sample from a dense state vector. The vector is consumed in the process.
+   * @param amplitudes the amplitudes of the state
+   * @param shots number of samples to draw
+   * @return a map from the strings representing basis states to the number of
+   * times they have been measured
+   */
   std::map<std::string, std::size_t> sampleFromAmplitudeVectorInPlace(
       std::vector<std::complex<dd::fp>>& amplitudes, std::size_t shots);
+  PackedHistogram sampleFromAmplitudeVectorInPlaceCompact(
+      std::vector<std::complex<dd::fp>>& amplitudes, std::size_t shots);
 
   [[nodiscard]] dd::CVec getVector() const {
     if (getNumberOfQubits() >= 60) {
@@ -201,6 +253,11 @@ protected:
   std::uint64_t seed = 0;
   bool hasFixedSeed;
   dd::fp epsilon = 0.001;
+  std::size_t samplingThreads = 0;
+  GarbageCollectionPolicy gcPolicy;
+
+  // to be called wherever an operation has been applied to the state
+  void collectGarbage() { gcPolicy.maybeCollect(*dd); }
 
   virtual void exportDDtoGraphviz(std::ostream& os, bool colored,
                                   bool edgeLabels, bool classic, bool memory,
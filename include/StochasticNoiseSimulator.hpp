@@ -2,6 +2,8 @@
 
 #include "CircuitSimulator.hpp"
 #include "Definitions.hpp"
+#include "GarbageCollectionPolicy.hpp"
+#include "PackedBitString.hpp"
 #include "dd/DDpackageConfig.hpp"
 #include "dd/NoiseFunctionality.hpp"
 #include "ir/QuantumComputation.hpp"
@@ -68,10 +70,11 @@ public:
                                         multiQubitGateFactor);
   }
 
-  std::vector<std::map<std::string, size_t>> classicalMeasurementsMaps;
-  std::map<std::string, size_t> finalClassicalMeasurementsMap;
+  std::vector<PackedHistogram> classicalMeasurementsMaps;
+  PackedHistogram finalClassicalMeasurementsMap;
 
   std::map<std::string, std::size_t> simulate(std::size_t shots) override;
+  PackedHistogram simulateCompact(std::size_t shots) override;
 
   [[nodiscard]] std::size_t getMaxMatrixNodeCount() const override {
     return 0U;
@@ -98,6 +101,6 @@ private:
 
   void runStochSimulationForId(
       std::size_t stochRun, qc::Qubit nQubits,
-      std::map<std::string, size_t>& classicalMeasurementsMap,
-      std::uint64_t localSeed);
+      PackedHistogram& classicalMeasurementsMap,
+      GarbageCollectionPolicy& localGcPolicy, std::uint64_t localSeed);
 };
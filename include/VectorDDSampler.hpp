@@ -0,0 +1,65 @@
+#pragma once
+
+#include "PackedBitString.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+/**
+ * Weak simulation of a vector DD. The branch probabilities of all nodes are
+ * computed once in a single bottom-up pass, after which arbitrarily many
+ * samples can be drawn by descending from the root without touching the DD
+ * package again.
+ */
+class VectorDDSampler {
+public:
+  VectorDDSampler(const dd::vEdge& root, std::size_t nqubits);
+
+  /**
+   * Draw samples from the state.
+   * @param shots number of samples to draw
+   * @param mt random number generator to use
+   * @return a histogram of the sampled outcomes
+   */
+  [[nodiscard]] PackedHistogram sample(std::size_t shots,
+                                       std::mt19937_64& mt) const;
+
+  /**
+   * Draw samples from the state using multiple threads. The shots are split
+   * into fixed-size chunks, each of which is sampled with its own random
+   * number generator seeded from `mt`. Hence, the result for a fixed seed does
+   * not depend on the number of threads.
+   * @param shots number of samples to draw
+   * @param mt random number generator used to derive the per-chunk seeds
+   * @param nthreads number of worker threads
+   * @return a histogram of the sampled outcomes
+   */
+  [[nodiscard]] PackedHistogram sample(std::size_t shots, std::mt19937_64& mt,
+                                       std::size_t nthreads) const;
+
+  [[nodiscard]] std::size_t getNumberOfQubits() const { return nqubits; }
+
+private:
+  static constexpr std::size_t SHOTS_PER_CHUNK = 1U << 16U;
+  static constexpr std::size_t TERMINAL =
+      std::numeric_limits<std::size_t>::max();
+
+  struct Node {
+    std::array<std::size_t, dd::RADIX> children{TERMINAL, TERMINAL};
+    dd::fp zeroProbability{};
+    dd::Qubit v{};
+  };
+
+  void sampleInto(PackedHistogram& histogram, std::size_t shots,
+                  std::mt19937_64& mt) const;
+
+  std::size_t nqubits;
+  std::size_t root = TERMINAL;
+  // flattened copy of the DD that can be traversed without hashing
+  std::vector<Node> nodes;
+};
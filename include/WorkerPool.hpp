@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/**
+ * A pool of local worker processes for distributing independent work items.
+ * The calling process acts as the coordinator. It forks the workers, hands out
+ * ranges of items over pipes whenever a worker has finished its previous
+ * range, and finally collects one result per worker. Since the workers are
+ * forked, they share the coordinator's state at the time `run` is called.
+ *
+ * Only available on POSIX systems.
+ */
+class WorkerPool {
+public:
+  // processes the items [first, first + count) within a worker process
+  using ProcessRange =
+      std::function<void(std::size_t first, std::size_t count)>;
+  // produces the result of a worker process once all of its items are done
+  using Finish = std::function<std::string()>;
+  // called by the coordinator with the result of every worker
+  using Collect = std::function<void(std::string&& result)>;
+
+  explicit WorkerPool(std::size_t nworkers_);
+
+  [[nodiscard]] static bool isSupported();
+
+  /**
+   * Process the items [0, nitems) in ranges of at most `rangeSize` items.
+   * Throws a std::runtime_error if a worker process fails, carrying the
+   * message of the exception that stopped the worker, if any.
+   */
+  void run(std::size_t nitems, std::size_t rangeSize,
+           const ProcessRange& process, const Finish& finish,
+           const Collect& collect) const;
+
+  [[nodiscard]] std::size_t getNumberOfWorkers() const { return nworkers; }
+
+private:
+  std::size_t nworkers;
+};
@@ -0,0 +1,114 @@
+#include "AliasSampler.hpp"
+
+#include "dd/DDDefinitions.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+AliasSampler::AliasSampler(const std::vector<dd::fp>& weights)
+    : table(weights.size()) {
+  for (std::size_t i = 0; i < weights.size(); ++i) {
+    table[i] = {weights[i], 0.};
+  }
+  build();
+}
+
+AliasSampler::AliasSampler(std::vector<std::complex<dd::fp>>&& amplitudes)
+    : table(std::move(amplitudes)) {
+  for (auto& entry : table) {
+    entry = {std::norm(entry), 0.};
+  }
+  build();
+}
+
+void AliasSampler::build() {
+  const auto n = table.size();
+  dd::fp total = 0.;
+  for (const auto& entry : table) {
+    total += entry.real();
+  }
+  if (n == 0 || total <= 0.) {
+    throw std::runtime_error(
+        "Cannot sample from a distribution without any probability mass.");
+  }
+
+  // scale such that the average column height is one and let every column
+  // initially alias itself
+  const auto scale = static_cast<dd::fp>(n) / total;
+  for (std::size_t i = 0; i < n; ++i) {
+    table[i] = {table[i].real() * scale, static_cast<dd::fp>(i)};
+  }
+
+  // Vose's construction without auxiliary work lists: two cursors scan for
+  // the next column below and above average height, respectively. A column
+  // that becomes small after donating to a column the small cursor has
+  // already passed is processed immediately, all others are found by the
+  // small cursor later on.
+  const auto nextSmall = [&](std::size_t i) {
+    while (i < n && table[i].real() >= 1.) {
+      ++i;
+    }
+    return i;
+  };
+  const auto nextLarge = [&](std::size_t i) {
+    while (i < n && table[i].real() < 1.) {
+      ++i;
+    }
+    return i;
+  };
+
+  auto small = nextSmall(0);
+  auto large = nextLarge(0);
+  auto current = small;
+  while (current < n && large < n) {
+    auto& donor = table[large];
+    table[current].imag(static_cast<dd::fp>(large));
+    donor.real((donor.real() + table[current].real()) - 1.);
+    if (donor.real() < 1. && large < small) {
+      current = large;
+      large = nextLarge(large + 1);
+    } else {
+      if (donor.real() < 1.) {
+        large = nextLarge(large + 1);
+      }
+      small = nextSmall(small + 1);
+      current = small;
+    }
+  }
+
+  // whatever is left over only differs from one due to rounding errors
+  if (current < n) {
+    table[current].real(1.);
+    for (small = nextSmall(small + 1); small < n;
+         small = nextSmall(small + 1)) {
+      table[small].real(1.);
+    }
+  }
+  for (; large < n; large = nextLarge(large + 1)) {
+    table[large].real(1.);
+  }
+}
+
+std::size_t AliasSampler::operator()(std::mt19937_64& mt) const {
+  std::uniform_int_distribution<std::size_t> column(0, table.size() - 1);
+  std::uniform_real_distribution<dd::fp> coin(0.0, 1.0);
+  const auto idx = column(mt);
+  const auto& entry = table[idx];
+  if (coin(mt) < entry.real()) {
+    return idx;
+  }
+  return static_cast<std::size_t>(entry.imag());
+}
+
+IndexHistogram AliasSampler::sample(const std::size_t shots,
+                                    std::mt19937_64& mt) const {
+  IndexHistogram histogram;
+  for (std::size_t i = 0; i < shots; ++i) {
+    ++histogram[(*this)(mt)];
+  }
+  return histogram;
+}
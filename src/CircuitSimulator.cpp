@@ -1,23 +1,36 @@
 #include "CircuitSimulator.hpp"
 
+#include "PackedBitString.hpp"
 #include "Simulator.hpp"
+#include "dd/ComplexNumbers.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
 #include "dd/FunctionalityConstruction.hpp"
 #include "dd/Node.hpp"
 #include "dd/Operations.hpp"
+#include "dd/RealNumber.hpp"
 #include "ir/operations/ClassicControlledOperation.hpp"
 #include "ir/operations/NonUnitaryOperation.hpp"
 #include "ir/operations/OpType.hpp"
+#include "ir/operations/Operation.hpp"
+#include "ir/operations/StandardOperation.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <random>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using CN = dd::ComplexNumbers;
 
 template <class Config>
 std::map<std::string, std::size_t>
@@ -56,23 +69,297 @@ CircuitSimulator<Config>::simulate(std::size_t shots) {
   }
 
   // the circuit is dynamic and requires single shot simulations :(
+  if (supportsMeasurementBranching()) {
+    return simulateByMeasurementBranching(shots);
+  }
+  if (shotThreads > 0 && supportsParallelShots()) {
+    return simulateShotsInParallel(shots);
+  }
+
   std::map<std::string, std::size_t> measurementCounter;
 
   for (unsigned int i = 0; i < shots; i++) {
     const auto result = singleShot(false);
-    const auto cbits = qc->getNcbits();
+    measurementCounter[toClassicalRegisterString(result)]++;
+  }
+  return measurementCounter;
+}
 
-    std::string resultString(qc->getNcbits(), '0');
+template <class Config>
+PackedHistogram
+CircuitSimulator<Config>::simulateCompact(const std::size_t shots) {
+  const auto analysis = CircuitSimulator<Config>::analyseCircuit();
+
+  if (!analysis.isDynamic && !analysis.hasMeasurements) {
+    singleShot(false);
+    return this->measureAllNonCollapsingCompact(shots);
+  }
 
-    // result is a map from the cbit index to the Boolean value
-    for (const auto& [bitIndex, value] : result) {
-      resultString[cbits - bitIndex - 1] = value ? '1' : '0';
+  if (!analysis.isDynamic) {
+    singleShot(true);
+    PackedHistogram measurementCounter;
+    PackedBitString result(packedWords(qc->getNcbits()), 0U);
+    for (const auto& [bits, count] :
+         this->measureAllNonCollapsingCompact(shots)) {
+      std::fill(result.begin(), result.end(), 0U);
+      for (auto const& [qubitIndex, bitIndex] : analysis.measurementMap) {
+        if (((bits[qubitIndex / 64U] >> (qubitIndex % 64U)) & 1U) != 0U) {
+          result[bitIndex / 64U] |= 1ULL << (bitIndex % 64U);
+        }
+      }
+      measurementCounter[result] += count;
     }
-    measurementCounter[resultString]++;
+    return measurementCounter;
+  }
+
+  // results of dynamic circuits are collected per classical register anyway
+  return toPackedHistogram(simulate(shots));
+}
+
+template <class Config>
+std::map<std::string, std::size_t>
+CircuitSimulator<Config>::simulateShotsInParallel(const std::size_t shots) {
+  const auto nblocks = (shots + SHOTS_PER_BLOCK - 1) / SHOTS_PER_BLOCK;
+  // seeds are drawn per block (not per thread) to keep the result independent
+  // of the number of threads
+  std::vector<std::uint64_t> blockSeeds(nblocks);
+  for (auto& blockSeed : blockSeeds) {
+    blockSeed = Simulator<Config>::mt();
+  }
+
+  const auto nthreads = std::max<std::size_t>(
+      1U, std::min<std::size_t>(shotThreads, nblocks));
+  std::vector<std::unique_ptr<CircuitSimulator<Config>>> workers;
+  workers.reserve(nthreads);
+  for (std::size_t t = 0U; t < nthreads; ++t) {
+    auto worker = std::make_unique<CircuitSimulator<Config>>(
+        std::make_unique<qc::QuantumComputation>(*qc), approximationInfo, 0U);
+    worker->maxFusionQubits = maxFusionQubits;
+    worker->prefixCaching = prefixCaching;
+    worker->gcPolicy = Simulator<Config>::gcPolicy.clone();
+    workers.emplace_back(std::move(worker));
+  }
+
+  std::vector<std::map<std::string, std::size_t>> threadCounters(nthreads);
+  std::vector<std::thread> threads;
+  threads.reserve(nthreads);
+  for (std::size_t t = 0U; t < nthreads; ++t) {
+    threads.emplace_back([this, t, nthreads, nblocks, shots, &blockSeeds,
+                          &workers, &threadCounters]() {
+      auto& worker = *workers.at(t);
+      auto& counter = threadCounters.at(t);
+      for (std::size_t block = t; block < nblocks; block += nthreads) {
+        worker.mt.seed(blockSeeds.at(block));
+        const auto blockStart = block * SHOTS_PER_BLOCK;
+        const auto blockEnd = std::min(blockStart + SHOTS_PER_BLOCK, shots);
+        for (std::size_t i = blockStart; i < blockEnd; ++i) {
+          const auto result = worker.singleShot(false);
+          counter[toClassicalRegisterString(result)]++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::map<std::string, std::size_t> measurementCounter;
+  for (std::size_t t = 0U; t < nthreads; ++t) {
+    for (const auto& [state, count] : threadCounters.at(t)) {
+      measurementCounter[state] += count;
+    }
+    const auto& worker = *workers.at(t);
+    singleShots += worker.singleShots;
+    fusedGates += worker.fusedGates;
+    unfusedGates += worker.unfusedGates;
+    prefixCacheHits += worker.prefixCacheHits;
+    approximationRuns += worker.approximationRuns;
+    finalFidelity *= worker.finalFidelity;
+    Simulator<Config>::gcPolicy.mergeStatistics(worker.gcPolicy);
   }
   return measurementCounter;
 }
 
+template <class Config>
+bool CircuitSimulator<Config>::isClassicConditionSatisfied(
+    const std::unique_ptr<qc::Operation>& op,
+    std::map<std::size_t, bool>& classicValues) {
+  auto* classicallyControlledOp =
+      dynamic_cast<qc::ClassicControlledOperation*>(op.get());
+  if (classicallyControlledOp == nullptr) {
+    throw std::runtime_error(
+        "Dynamic cast to ClassicControlledOperation failed.");
+  }
+  const auto startIndex = static_cast<std::uint16_t>(
+      classicallyControlledOp->getParameter().at(0));
+  const auto length = static_cast<std::uint16_t>(
+      classicallyControlledOp->getParameter().at(1));
+  const auto expectedValue = classicallyControlledOp->getExpectedValue();
+  unsigned int actualValue = 0;
+  for (std::size_t i = 0; i < length; i++) {
+    actualValue |= (classicValues[startIndex + i] ? 1U : 0U) << i;
+  }
+  return actualValue == expectedValue;
+}
+
+template <class Config>
+std::map<std::string, std::size_t>
+CircuitSimulator<Config>::simulateByMeasurementBranching(
+    const std::size_t shots) {
+  branchMemo.clear();
+  auto initialState = Simulator<Config>::dd->makeZeroState(
+      static_cast<dd::Qubit>(qc->getNqubits()));
+  Simulator<Config>::dd->incRef(initialState);
+  outcomeProbabilities = branchOnOutcomes(0, 0, initialState, {}, 1.);
+
+  for (auto& [key, entry] : branchMemo) {
+    Simulator<Config>::dd->decRef(entry.first);
+  }
+  branchMemo.clear();
+  Simulator<Config>::dd->garbageCollect();
+
+  if (outcomeProbabilities.empty()) {
+    throw std::runtime_error(
+        "All measurement branches have been pruned. Consider lowering the "
+        "pruning threshold.");
+  }
+
+  // the probability mass of pruned branches is implicitly re-distributed
+  std::vector<std::string> outcomes;
+  std::vector<dd::fp> weights;
+  outcomes.reserve(outcomeProbabilities.size());
+  weights.reserve(outcomeProbabilities.size());
+  for (const auto& [outcome, probability] : outcomeProbabilities) {
+    outcomes.emplace_back(outcome);
+    weights.emplace_back(probability);
+  }
+  std::discrete_distribution<std::size_t> d(
+      weights.begin(),
+      weights.end()); // NOLINT(misc-const-correctness) false-positive
+
+  std::map<std::string, std::size_t> measurementCounter;
+  for (std::size_t i = 0; i < shots; ++i) {
+    measurementCounter[outcomes[d(Simulator<Config>::mt)]]++;
+  }
+  return measurementCounter;
+}
+
+/**
+ * Compute the distribution over the classical outcomes of a dynamic circuit
+ * starting from a given position in the circuit.
+ * @tparam Config Configuration for the underlying DD package
+ * @param opIdx index of the operation to continue the simulation with
+ * @param targetIdx index of the next target qubit if the operation at opIdx is
+ * a measurement or reset
+ * @param state current (normalized) state, the function takes over one
+ * reference of it
+ * @param classicValues values of the classical bits determined so far
+ * @param pathProbability probability of reaching this branch, used for pruning
+ * @return a map from classical outcomes to their conditional probability
+ */
+template <class Config>
+std::map<std::string, dd::fp> CircuitSimulator<Config>::branchOnOutcomes(
+    std::size_t opIdx, std::size_t targetIdx, dd::vEdge state,
+    std::map<std::size_t, bool> classicValues, const dd::fp pathProbability) {
+  for (; opIdx < qc->getNops(); ++opIdx, targetIdx = 0) {
+    const auto& op = qc->at(opIdx);
+    if (op->isNonUnitaryOperation()) {
+      auto* nonUnitaryOp = dynamic_cast<qc::NonUnitaryOperation*>(op.get());
+      if (nonUnitaryOp == nullptr) {
+        throw std::runtime_error("Dynamic cast to NonUnitaryOperation failed.");
+      }
+      if (op->getType() != qc::Measure && op->getType() != qc::Reset) {
+        throw std::runtime_error("Unsupported non-unitary functionality.");
+      }
+      const auto& targets = nonUnitaryOp->getTargets();
+      if (targetIdx >= targets.size()) {
+        continue;
+      }
+
+      BranchKey key{opIdx, targetIdx, state.p,
+                    toClassicalRegisterString(classicValues)};
+      if (const auto it = branchMemo.find(key); it != branchMemo.end()) {
+        branchMemoHits++;
+        Simulator<Config>::dd->decRef(state);
+        return it->second.second;
+      }
+
+      const auto qubit = targets.at(targetIdx);
+      const auto norm = CN::mag2(state.w);
+      std::map<std::string, dd::fp> distribution;
+      for (const bool outcome : {false, true}) {
+        // keep only the part of the state that is consistent with the outcome
+        auto next = Simulator<Config>::dd->deleteEdge(
+            state, static_cast<dd::Qubit>(qubit), outcome ? 0 : 1);
+        const auto probability = CN::mag2(next.w) / norm;
+        if (probability < dd::RealNumber::eps) {
+          continue;
+        }
+        if (pathProbability * probability < branchPruningThreshold) {
+          prunedBranches++;
+          continue;
+        }
+        next.w = Simulator<Config>::dd->cn.lookup(
+            next.w / std::sqrt(CN::mag2(next.w)));
+        Simulator<Config>::dd->incRef(next);
+
+        auto nextValues = classicValues;
+        if (op->getType() == qc::Measure) {
+          nextValues[nonUnitaryOp->getClassics().at(targetIdx)] = outcome;
+        } else if (outcome) {
+          const auto x = qc::StandardOperation(qubit, qc::X);
+          auto tmp = Simulator<Config>::dd->multiply(
+              dd::getDD(&x, *Simulator<Config>::dd), next);
+          Simulator<Config>::dd->incRef(tmp);
+          Simulator<Config>::dd->decRef(next);
+          next = tmp;
+        }
+
+        for (const auto& [outcomeString, conditionalProbability] :
+             branchOnOutcomes(opIdx, targetIdx + 1, next, nextValues,
+                              pathProbability * probability)) {
+          distribution[outcomeString] += probability * conditionalProbability;
+        }
+      }
+
+      // the memo takes over the reference to the state
+      branchMemo.emplace(std::move(key), std::pair{state, distribution});
+      return distribution;
+    }
+
+    if (op->isClassicControlledOperation() &&
+        !isClassicConditionSatisfied(op, classicValues)) {
+      continue;
+    }
+    if (op->getType() == qc::Barrier) {
+      continue;
+    }
+    auto tmp = Simulator<Config>::dd->multiply(
+        dd::getDD(op.get(), *Simulator<Config>::dd), state);
+    Simulator<Config>::dd->incRef(tmp);
+    Simulator<Config>::dd->decRef(state);
+    state = tmp;
+    Simulator<Config>::collectGarbage();
+  }
+
+  outcomeBranches++;
+  Simulator<Config>::dd->decRef(state);
+  return {{toClassicalRegisterString(classicValues), 1.}};
+}
+
+template <class Config>
+std::string CircuitSimulator<Config>::toClassicalRegisterString(
+    const std::map<std::size_t, bool>& values) const {
+  const auto cbits = qc->getNcbits();
+  std::string resultString(cbits, '0');
+
+  // values is a map from the cbit index to the Boolean value
+  for (const auto& [bitIndex, value] : values) {
+    resultString[cbits - bitIndex - 1] = value ? '1' : '0';
+  }
+  return resultString;
+}
+
 template <class Config>
 auto CircuitSimulator<Config>::analyseCircuit() -> CircuitAnalysis {
   auto analysis = CircuitAnalysis{};
@@ -147,7 +434,7 @@ void CircuitSimulator<Config>::reset(qc::NonUnitaryOperation* nonUnitaryOp) {
       Simulator<Config>::dd->incRef(tmp);
       Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
       Simulator<Config>::rootEdge = tmp;
-      Simulator<Config>::dd->garbageCollect();
+      Simulator<Config>::collectGarbage();
     }
   }
 }
@@ -168,20 +455,42 @@ CircuitSimulator<Config>::singleShot(const bool ignoreNonUnitaries) {
   singleShots++;
   const auto nQubits = qc->getNqubits();
 
-  initializeSimulation(nQubits);
-
   std::size_t opNum = 0;
   std::map<std::size_t, bool> classicValues;
 
+  // the unitary prefix up to the first non-unitary operation is the same for
+  // every shot and only has to be simulated once
+  const bool usePrefixCache = !ignoreNonUnitaries && supportsPrefixCaching();
+  if (usePrefixCache && prefixCached) {
+    Simulator<Config>::rootEdge = prefixState;
+    Simulator<Config>::dd->incRef(Simulator<Config>::rootEdge);
+    opNum = prefixLength;
+    prefixCacheHits++;
+  } else {
+    initializeSimulation(nQubits);
+  }
+
   const auto approxMod = static_cast<std::size_t>(
       std::ceil(static_cast<double>(qc->getNops()) /
                 (static_cast<double>(approximationInfo.stepNumber + 1))));
 
-  for (auto& op : *qc) {
+  for (auto it = std::next(qc->begin(), static_cast<std::ptrdiff_t>(opNum));
+       it != qc->end(); ++it) {
+    auto& op = *it;
+    if (usePrefixCache && !prefixCached &&
+        (op->isNonUnitaryOperation() || op->isClassicControlledOperation())) {
+      applyFusedOperation();
+      prefixState = Simulator<Config>::rootEdge;
+      Simulator<Config>::dd->incRef(prefixState);
+      prefixLength = static_cast<std::size_t>(std::distance(qc->begin(), it));
+      prefixCached = true;
+    }
+
     if (op->isNonUnitaryOperation()) {
       if (ignoreNonUnitaries) {
         continue;
       }
+      applyFusedOperation();
       if (auto* nonUnitaryOp =
               dynamic_cast<qc::NonUnitaryOperation*>(op.get())) {
         if (op->getType() == qc::Measure) {
@@ -206,34 +515,21 @@ CircuitSimulator<Config>::singleShot(const bool ignoreNonUnitaries) {
       } else {
         throw std::runtime_error("Dynamic cast to NonUnitaryOperation failed.");
       }
-      Simulator<Config>::dd->garbageCollect();
+      Simulator<Config>::collectGarbage();
     } else {
-      if (op->isClassicControlledOperation()) {
-        if (auto* classicallyControlledOp =
-                dynamic_cast<qc::ClassicControlledOperation*>(op.get())) {
-          const auto startIndex = static_cast<std::uint16_t>(
-              classicallyControlledOp->getParameter().at(0));
-          const auto length = static_cast<std::uint16_t>(
-              classicallyControlledOp->getParameter().at(1));
-          const auto expectedValue =
-              classicallyControlledOp->getExpectedValue();
-          unsigned int actualValue = 0;
-          for (std::size_t i = 0; i < length; i++) {
-            actualValue |= (classicValues[startIndex + i] ? 1U : 0U) << i;
-          }
-
-          // std::clog << "expected " << expected_value << " and actual value
-          // was " << actual_value << "\n";
-
-          if (actualValue != expectedValue) {
-            continue;
-          }
-        } else {
-          throw std::runtime_error(
-              "Dynamic cast to ClassicControlledOperation failed.");
-        }
+      if (op->isClassicControlledOperation() &&
+          !isClassicConditionSatisfied(op, classicValues)) {
+        continue;
+      }
+      if (supportsGateFusion() && !op->isClassicControlledOperation()) {
+        fuseOperation(op);
+        opNum++;
+        continue;
       }
+      applyFusedOperation();
       applyOperationToState(op);
+      unfusedGates++;
+      enforceMemoryBudget();
 
       if (approximationInfo.stepNumber > 0 &&
           approximationInfo.stepFidelity < 1.0) {
@@ -259,13 +555,124 @@ CircuitSimulator<Config>::singleShot(const bool ignoreNonUnitaries) {
           }
         }
       }
-      Simulator<Config>::dd->garbageCollect();
+      Simulator<Config>::collectGarbage();
     }
     opNum++;
   }
+  applyFusedOperation();
   return classicValues;
 }
 
+template <class Config>
+void CircuitSimulator<Config>::fuseOperation(
+    const std::unique_ptr<qc::Operation>& op) {
+  if (op->getType() == qc::Barrier) {
+    return;
+  }
+
+  // start a new block if the operation does not fit into the current one
+  const auto usedQubits = op->getUsedQubits();
+  auto combinedQubits = fusedQubits;
+  combinedQubits.insert(usedQubits.begin(), usedQubits.end());
+  if (combinedQubits.size() > maxFusionQubits) {
+    applyFusedOperation();
+    combinedQubits = usedQubits;
+  }
+
+  const auto opDD = dd::getDD(op.get(), *Simulator<Config>::dd);
+  auto tmp = opDD;
+  if (fusedOperationCount > 0) {
+    tmp = Simulator<Config>::dd->multiply(opDD, fusedOperation);
+  }
+  Simulator<Config>::dd->incRef(tmp);
+  if (fusedOperationCount > 0) {
+    Simulator<Config>::dd->decRef(fusedOperation);
+  }
+  fusedOperation = tmp;
+  fusedQubits = std::move(combinedQubits);
+  fusedOperationCount++;
+}
+
+template <class Config> void CircuitSimulator<Config>::applyFusedOperation() {
+  if (fusedOperationCount == 0) {
+    return;
+  }
+
+  auto tmp = Simulator<Config>::dd->multiply(fusedOperation,
+                                             Simulator<Config>::rootEdge);
+  Simulator<Config>::dd->incRef(tmp);
+  Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
+  Simulator<Config>::rootEdge = tmp;
+  Simulator<Config>::dd->decRef(fusedOperation);
+
+  if (fusedOperationCount == 1) {
+    unfusedGates++;
+  } else {
+    fusedGates += fusedOperationCount;
+  }
+  fusedOperation = dd::mEdge{};
+  fusedQubits.clear();
+  fusedOperationCount = 0;
+  Simulator<Config>::collectGarbage();
+  enforceMemoryBudget();
+}
+
+template <class Config>
+std::size_t CircuitSimulator<Config>::estimateMemoryUsage() const {
+  // the compute tables are fixed-size arrays and do not grow with the DDs
+  const auto& vUniqueTable =
+      Simulator<Config>::dd->template getUniqueTable<dd::vNode>();
+  const auto& mUniqueTable =
+      Simulator<Config>::dd->template getUniqueTable<dd::mNode>();
+  return (vUniqueTable.getNumEntries() * sizeof(dd::vNode)) +
+         (mUniqueTable.getNumEntries() * sizeof(dd::mNode));
+}
+
+template <class Config> void CircuitSimulator<Config>::enforceMemoryBudget() {
+  if (memoryBudget == 0 || !supportsMemoryBudget()) {
+    return;
+  }
+
+  auto usage = estimateMemoryUsage();
+  if (usage > memoryBudget) {
+    // first, get rid of all dead nodes
+    Simulator<Config>::dd->garbageCollect(true);
+    budgetGarbageCollections++;
+    usage = estimateMemoryUsage();
+  }
+
+  if (usage > memoryBudget) {
+    // second, drop all cached results so that no node is kept alive by them
+    Simulator<Config>::dd->clearComputeTables();
+    Simulator<Config>::dd->garbageCollect(true);
+    budgetComputeTableFlushes++;
+    usage = estimateMemoryUsage();
+  }
+
+  // finally, approximate the state while doubling the fidelity given up in
+  // each round
+  dd::fp fidelityLoss = 0.01;
+  while (usage > memoryBudget) {
+    const auto targetFidelity =
+        std::max(minBudgetFidelity, static_cast<dd::fp>(1. - fidelityLoss));
+    const auto fidelity =
+        Simulator<Config>::approximateByFidelity(targetFidelity, false, true);
+    Simulator<Config>::dd->garbageCollect(true);
+    budgetApproximations++;
+    budgetFidelity *= static_cast<long double>(fidelity);
+    finalFidelity *= static_cast<long double>(fidelity);
+    usage = estimateMemoryUsage();
+    if (targetFidelity <= minBudgetFidelity) {
+      break;
+    }
+    fidelityLoss *= 2;
+  }
+  if (usage > memoryBudget) {
+    budgetViolations++;
+  }
+  peakMemory = std::max(peakMemory, usage);
+}
+
 template class CircuitSimulator<dd::DDPackageConfig>;
 template class CircuitSimulator<dd::UnitarySimulatorDDPackageConfig>;
 template class CircuitSimulator<dd::DensityMatrixSimulatorDDPackageConfig>;
@@ -1,5 +1,7 @@
 #include "DeterministicNoiseSimulator.hpp"
 
+#include "AliasSampler.hpp"
+#include "PackedBitString.hpp"
 #include "Simulator.hpp"
 #include "dd/ComplexNumbers.hpp"
 #include "dd/DDDefinitions.hpp"
@@ -9,11 +11,8 @@
 #include "ir/operations/Operation.hpp"
 
 #include <cstddef>
-#include <cstdint>
-#include <iterator>
 #include <map>
 #include <memory>
-#include <random>
 #include <string>
 #include <vector>
 
@@ -50,28 +49,24 @@ void DeterministicNoiseSimulator::reset(qc::NonUnitaryOperation* nonUnitaryOp) {
   }
 }
 
-std::map<std::string, std::size_t>
-DeterministicNoiseSimulator::sampleFromProbabilityMap(
+PackedHistogram DeterministicNoiseSimulator::sampleFromProbabilityMap(
     const dd::SparsePVecStrKeys& resultProbabilityMap,
     const std::size_t shots) {
+  std::vector<const std::string*> states;
   std::vector<dd::fp> weights;
+  states.reserve(resultProbabilityMap.size());
   weights.reserve(resultProbabilityMap.size());
   for (const auto& [state, prob] : resultProbabilityMap) {
+    states.emplace_back(&state);
     weights.emplace_back(prob);
   }
-  std::discrete_distribution<std::size_t> d(
-      weights.begin(),
-      weights.end()); // NOLINT(misc-const-correctness) false-positive
+  const AliasSampler sampler(weights);
 
   // Create the final map containing the measurement results and the
   // corresponding shots
-  std::map<std::string, std::size_t> results;
-  for (size_t n = 0; n < shots; ++n) {
-    const auto sampleIdx = d(mt);
-    const auto state = (std::next(resultProbabilityMap.begin(),
-                                  static_cast<std::int64_t>(sampleIdx)))
-                           ->first;
-    results[state] += 1;
+  PackedHistogram results;
+  for (const auto& [index, count] : sampler.sample(shots, mt)) {
+    results.emplace(fromBitString(*states[index]), count);
   }
 
   return results;
@@ -91,7 +91,7 @@ GroverSimulator<Config>::simulate(std::size_t shots) {
     Simulator<Config>::dd->incRef(tmp);
     Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
     Simulator<Config>::rootEdge = tmp;
-    Simulator<Config>::dd->garbageCollect();
+    Simulator<Config>::collectGarbage();
     jPre++;
   }
 
@@ -106,7 +106,7 @@ GroverSimulator<Config>::simulate(std::size_t shots) {
     Simulator<Config>::dd->incRef(tmp);
     Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
     Simulator<Config>::rootEdge = tmp;
-    Simulator<Config>::dd->garbageCollect();
+    Simulator<Config>::collectGarbage();
   }
 
   return Simulator<Config>::measureAllNonCollapsing(shots);
@@ -2,7 +2,9 @@
 
 #include "CircuitSimulator.hpp"
 #include "Definitions.hpp"
+#include "PackedBitString.hpp"
 #include "Simulator.hpp"
+#include "WorkerPool.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
 #include "dd/Export.hpp"
@@ -19,11 +21,19 @@
 #include <complex>
 #include <cstddef>
 #include <cstdint>
-#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <functional>
+#include <ios>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <ostream>
+#include <random>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <taskflow/core/async.hpp>
@@ -31,95 +41,687 @@
 #include <utility>
 #include <vector>
 
+namespace {
+// control values of the paths [first, first + count) when enumerating the
+// paths in the order of the decision tree, i.e., consecutive paths share the
+// earliest decisions (which are stored in the lowest bits of the control)
+std::vector<std::size_t> treeControls(const std::size_t first,
+                                      const std::size_t count,
+                                      const std::size_t ndecisions) {
+  std::vector<std::size_t> controls;
+  controls.reserve(count);
+  for (auto path = first; path < first + count; ++path) {
+    std::size_t control = 0;
+    for (std::size_t bit = 0; bit < ndecisions; ++bit) {
+      control |= ((path >> bit) & 1U) << (ndecisions - 1 - bit);
+    }
+    controls.emplace_back(control);
+  }
+  return controls;
+}
+
+// add the amplitudes of `edge` (scaled by `weight`) with an index in
+// [begin, end) to `amplitudes`, where `offset` is the index of the edge's first
+// amplitude
+void addRangeToVector(const qc::VectorDD& edge,
+                      const std::complex<dd::fp>& weight,
+                      const std::size_t offset, const std::size_t begin,
+                      const std::size_t end, dd::CVec& amplitudes) {
+  if (edge.w.exactlyZero()) {
+    return;
+  }
+  const auto w = weight * static_cast<std::complex<dd::fp>>(edge.w);
+  if (edge.isTerminal()) {
+    amplitudes[offset] += w;
+    return;
+  }
+  const auto half = 1ULL << static_cast<std::size_t>(edge.p->v);
+  for (std::size_t i = 0; i < dd::RADIX; ++i) {
+    const auto childOffset = offset + (i * half);
+    if (childOffset < end && childOffset + half > begin) {
+      addRangeToVector(edge.p->e[i], w, childOffset, begin, end, amplitudes);
+    }
+  }
+}
+
+// amplitude of the basis state given by `bitstring` (q_n-1 ... q_0) in the
+// slice represented by `edge`, which only inspects the bits of the qubits the
+// slice acts on
+std::complex<dd::fp> amplitudeOf(const qc::VectorDD& edge,
+                                 const std::string& bitstring) {
+  std::complex<dd::fp> amplitude{1., 0.};
+  auto current = edge;
+  while (!current.w.exactlyZero()) {
+    amplitude *= static_cast<std::complex<dd::fp>>(current.w);
+    if (current.isTerminal()) {
+      return amplitude;
+    }
+    const auto qubit = static_cast<std::size_t>(current.p->v);
+    const auto bit = bitstring[bitstring.size() - 1 - qubit] == '1' ? 1U : 0U;
+    current = current.p->e[bit];
+  }
+  return 0.;
+}
+
+// index of the slice containing the given qubit
+std::size_t sliceOf(const std::vector<qc::Qubit>& splitQubits,
+                    const qc::Qubit qubit) {
+  return static_cast<std::size_t>(
+      std::upper_bound(splitQubits.begin(), splitQubits.end(), qubit) -
+      splitQubits.begin());
+}
+
+// dense matrix of a DD on `level` qubits (identities may be skipped)
+void fillMatrix(const qc::MatrixDD& e, const std::complex<dd::fp>& amp,
+                const std::size_t i, const std::size_t j, dd::CMat& matrix,
+                const std::size_t level) {
+  const auto c = amp * static_cast<std::complex<dd::fp>>(e.w);
+  if (level == 0U) {
+    matrix[i][j] = c;
+    return;
+  }
+
+  const auto nextLevel = level - 1U;
+  const auto x = i | (1ULL << nextLevel);
+  const auto y = j | (1ULL << nextLevel);
+  if (e.isTerminal() || static_cast<std::size_t>(e.p->v) < nextLevel) {
+    fillMatrix(e, c, i, j, matrix, nextLevel);
+    fillMatrix(e, c, x, y, matrix, nextLevel);
+    return;
+  }
+
+  const auto coords = {std::pair{i, j}, {i, y}, {x, j}, {x, y}};
+  std::size_t k = 0U;
+  for (const auto& [a, b] : coords) {
+    if (const auto& f = e.p->e[k++]; !f.w.exactlyZero()) {
+      fillMatrix(f, c, a, b, matrix, nextLevel);
+    }
+  }
+}
+
+// maximum number of qubits of a gate that is cut via its Schmidt
+// decomposition
+constexpr std::size_t MAX_DECOMPOSED_QUBITS = 8;
+} // namespace
+
 template <class Config>
 std::size_t
 HybridSchrodingerFeynmanSimulator<Config>::getNDecisions(qc::Qubit splitQubit) {
+  return getNDecisions(std::vector<qc::Qubit>{splitQubit});
+}
+
+template <class Config>
+std::size_t HybridSchrodingerFeynmanSimulator<Config>::getNDecisions(
+    const std::vector<qc::Qubit>& splitQubits) {
+  DecompositionPackages packages;
+  return countDecisions(splitQubits, packages);
+}
+
+template <class Config>
+std::size_t HybridSchrodingerFeynmanSimulator<Config>::countDecisions(
+    const std::vector<qc::Qubit>& splitQubits,
+    DecompositionPackages& packages) {
   std::size_t ndecisions = 0;
   // calculate number of decisions
   for (const auto& op : *CircuitSimulator<Config>::qc) {
-    if (op->getType() == qc::Barrier) {
-      continue;
+    if (const auto operands = cutOperands(*op, splitQubits)) {
+      ndecisions +=
+          decomposeCut(*op, operands->first, operands->second, packages).bits;
+    } else {
+      ndecisions += countCutControls(*op, splitQubits);
     }
+  }
+  return ndecisions;
+}
 
-    assert(op->isStandardOperation());
+template <class Config>
+std::size_t HybridSchrodingerFeynmanSimulator<Config>::countCutControls(
+    const qc::Operation& op, const std::vector<qc::Qubit>& splitQubits) {
+  if (op.getType() == qc::Barrier) {
+    return 0;
+  }
+
+  assert(op.isStandardOperation());
 
-    bool targetInLowerSlice = false;
-    bool targetInUpperSlice = false;
-    bool controlInLowerSlice = false;
-    size_t nControlsInLowerSlice = 0;
-    bool controlInUpperSlice = false;
-    size_t nControlsInUpperSlice = 0;
-    for (const auto& target : op->getTargets()) {
-      targetInLowerSlice = targetInLowerSlice || target < splitQubit;
-      targetInUpperSlice = targetInUpperSlice || target >= splitQubit;
+  const auto targetSlice = sliceOf(splitQubits, op.getTargets().front());
+  std::size_t nControlsInOtherSlices = 0;
+  for (const auto& control : op.getControls()) {
+    if (sliceOf(splitQubits, control.qubit) != targetSlice) {
+      ++nControlsInOtherSlices;
     }
-    for (const auto& control : op->getControls()) {
-      if (control.qubit < splitQubit) {
-        controlInLowerSlice = true;
-        nControlsInLowerSlice++;
-      } else {
-        controlInUpperSlice = true;
-        nControlsInUpperSlice++;
-      }
+  }
+  return nControlsInOtherSlices;
+}
+
+template <class Config>
+std::optional<std::pair<std::vector<qc::Qubit>, std::vector<qc::Qubit>>>
+HybridSchrodingerFeynmanSimulator<Config>::cutOperands(
+    const qc::Operation& op, const std::vector<qc::Qubit>& splitQubits) {
+  if (op.getType() == qc::Barrier) {
+    return std::nullopt;
+  }
+
+  assert(op.isStandardOperation());
+
+  const auto usedQubits = op.getUsedQubits();
+  std::set<std::size_t> slices;
+  for (const auto qubit : usedQubits) {
+    slices.emplace(sliceOf(splitQubits, qubit));
+  }
+  if (slices.size() == 1) {
+    return std::nullopt;
+  }
+  if (slices.size() > 2) {
+    throw std::invalid_argument(
+        "Gates spanning more than two slices of the circuit are not "
+        "supported.");
+  }
+
+  // gates with all targets in one slice and a single control in the other
+  // slice are directly cut at their control
+  const auto& targets = op.getTargets();
+  const auto targetSlice = sliceOf(splitQubits, targets.front());
+  const auto targetsInOneSlice =
+      std::all_of(targets.begin(), targets.end(), [&](const qc::Qubit target) {
+        return sliceOf(splitQubits, target) == targetSlice;
+      });
+  if (targetsInOneSlice && countCutControls(op, splitQubits) == 1) {
+    return std::nullopt;
+  }
+
+  if (usedQubits.size() > MAX_DECOMPOSED_QUBITS) {
+    throw std::invalid_argument(
+        "Cutting gates acting on more than " +
+        std::to_string(MAX_DECOMPOSED_QUBITS) +
+        " qubits is not supported as their Schmidt decomposition would be "
+        "too expensive.");
+  }
+
+  std::vector<qc::Qubit> lowerQubits;
+  std::vector<qc::Qubit> upperQubits;
+  const auto lowerSlice = *slices.begin();
+  for (const auto qubit : usedQubits) {
+    if (sliceOf(splitQubits, qubit) == lowerSlice) {
+      lowerQubits.emplace_back(qubit);
+    } else {
+      upperQubits.emplace_back(qubit);
     }
+  }
+  return std::pair{std::move(lowerQubits), std::move(upperQubits)};
+}
 
-    if (targetInLowerSlice && targetInUpperSlice) {
-      throw std::invalid_argument(
-          "Multiple targets spread across the cut through the circuit are not "
-          "supported at the moment as this would require actually computing "
-          "the Schmidt decomposition of the gate being cut.");
+template <class Config>
+const typename HybridSchrodingerFeynmanSimulator<Config>::CutDecomposition&
+HybridSchrodingerFeynmanSimulator<Config>::decomposeCut(
+    const qc::Operation& op, const std::vector<qc::Qubit>& lowerQubits,
+    const std::vector<qc::Qubit>& upperQubits,
+    DecompositionPackages& packages) {
+  const auto nlower = lowerQubits.size();
+  const auto nupper = upperQubits.size();
+  const auto nqubits = nlower + nupper;
+
+  // construct the gate on the qubits 0, ..., nqubits - 1 with the qubits of
+  // the lower slice below the ones of the upper slice
+  std::map<qc::Qubit, qc::Qubit> local;
+  for (std::size_t i = 0; i < nlower; ++i) {
+    local[lowerQubits[i]] = static_cast<qc::Qubit>(i);
+  }
+  for (std::size_t i = 0; i < nupper; ++i) {
+    local[upperQubits[i]] = static_cast<qc::Qubit>(nlower + i);
+  }
+  qc::Controls localControls{};
+  for (const auto& control : op.getControls()) {
+    localControls.emplace(local.at(control.qubit), control.type);
+  }
+  qc::Targets localTargets{};
+  for (const auto& target : op.getTargets()) {
+    localTargets.emplace_back(local.at(target));
+  }
+
+  CutKey key{op.getType(), op.getParameter(), localControls, localTargets,
+             nlower};
+  if (const auto it = decompositionCache.find(key);
+      it != decompositionCache.end()) {
+    return it->second;
+  }
+
+  const qc::StandardOperation localOp(localControls, localTargets,
+                                      op.getType(), op.getParameter());
+  auto& package = packages[nqubits];
+  if (!package) {
+    package = std::make_unique<dd::Package<Config>>(nqubits);
+  }
+  const auto gate = dd::getDD(&localOp, *package);
+  const auto dim = 1ULL << nqubits;
+  dd::CMat matrix(dim, dd::CVec(dim));
+  fillMatrix(gate, {1., 0.}, 0, 0, matrix, nqubits);
+
+  CutDecomposition decomposition;
+
+  // rearrange U[(aOut, bOut), (aIn, bIn)] to M[(aOut, aIn), (bOut, bIn)], so
+  // that the terms of the decomposition are the rank-one terms of M
+  const auto lowerDim = 1ULL << nlower;
+  const auto upperDim = 1ULL << nupper;
+  dd::CMat rearranged(lowerDim * lowerDim,
+                      dd::CVec(upperDim * upperDim, 0.));
+  for (std::size_t row = 0; row < dim; ++row) {
+    for (std::size_t col = 0; col < dim; ++col) {
+      const auto aOut = row % lowerDim;
+      const auto bOut = row / lowerDim;
+      const auto aIn = col % lowerDim;
+      const auto bIn = col / lowerDim;
+      rearranged[(aOut * lowerDim) + aIn][(bOut * upperDim) + bIn] =
+          matrix[row][col];
+    }
+  }
+
+  // rank-revealing elimination with complete pivoting, which yields as many
+  // terms as the Schmidt rank of the gate
+  const auto tolerance = 1e-12;
+  while (true) {
+    std::size_t pivotRow = 0;
+    std::size_t pivotCol = 0;
+    dd::fp largest = 0.;
+    for (std::size_t row = 0; row < rearranged.size(); ++row) {
+      for (std::size_t col = 0; col < rearranged[row].size(); ++col) {
+        if (std::abs(rearranged[row][col]) > largest) {
+          largest = std::abs(rearranged[row][col]);
+          pivotRow = row;
+          pivotCol = col;
+        }
+      }
+    }
+    if (largest < tolerance) {
+      break;
     }
 
-    if (targetInLowerSlice && controlInUpperSlice) {
-      if (nControlsInUpperSlice > 1) {
-        throw std::invalid_argument(
-            "Multiple controls in the control part of the gate being cut are "
-            "not supported at the moment as this would require actually "
-            "computing the Schmidt decomposition of the gate being cut.");
+    const auto pivot = rearranged[pivotRow][pivotCol];
+    dd::CVec column(rearranged.size());
+    for (std::size_t row = 0; row < rearranged.size(); ++row) {
+      column[row] = rearranged[row][pivotCol];
+    }
+    dd::CVec pivotRowValues = rearranged[pivotRow];
+    for (auto& value : pivotRowValues) {
+      value /= pivot;
+    }
+    for (std::size_t row = 0; row < rearranged.size(); ++row) {
+      for (std::size_t col = 0; col < rearranged[row].size(); ++col) {
+        rearranged[row][col] -= column[row] * pivotRowValues[col];
       }
-      ++ndecisions;
-    } else if (targetInUpperSlice && controlInLowerSlice) {
-      if (nControlsInLowerSlice > 1) {
-        throw std::invalid_argument(
-            "Multiple controls in the control part of the gate being cut are "
-            "not supported at the moment as this would require actually "
-            "computing the Schmidt decomposition of the gate being cut.");
+    }
+
+    dd::CMat lower(lowerDim, dd::CVec(lowerDim));
+    for (std::size_t i = 0; i < column.size(); ++i) {
+      lower[i / lowerDim][i % lowerDim] = column[i];
+    }
+    dd::CMat upper(upperDim, dd::CVec(upperDim));
+    for (std::size_t i = 0; i < pivotRowValues.size(); ++i) {
+      upper[i / upperDim][i % upperDim] = pivotRowValues[i];
+    }
+    decomposition.lower.emplace_back(std::move(lower));
+    decomposition.upper.emplace_back(std::move(upper));
+  }
+
+  while ((1ULL << decomposition.bits) < decomposition.lower.size()) {
+    ++decomposition.bits;
+  }
+  return decompositionCache.emplace(std::move(key), std::move(decomposition))
+      .first->second;
+}
+
+template <class Config>
+double HybridSchrodingerFeynmanSimulator<Config>::estimateSliceCost(
+    const qc::Qubit start, const qc::Qubit end) const {
+  const auto width = end - start + 1;
+  std::size_t gates = 0;
+  std::size_t entanglingGates = 0;
+  for (const auto& op : *CircuitSimulator<Config>::qc) {
+    std::size_t qubitsInSlice = 0;
+    for (const auto& qubit : op->getUsedQubits()) {
+      if (start <= qubit && qubit <= end) {
+        ++qubitsInSlice;
       }
-      ++ndecisions;
+    }
+    if (qubitsInSlice > 0) {
+      ++gates;
+    }
+    if (qubitsInSlice > 1) {
+      ++entanglingGates;
     }
   }
-  return ndecisions;
+  // each gate costs about as much as the size of the slice's state, which
+  // can only grow beyond one node per qubit through entangling gates
+  const auto exponent = std::min(static_cast<double>(entanglingGates),
+                                 static_cast<double>(width) / 2.);
+  return static_cast<double>(gates) * static_cast<double>(width) *
+         std::exp2(exponent);
 }
 
 template <class Config>
-qc::VectorDD HybridSchrodingerFeynmanSimulator<Config>::simulateSlicing(
-    std::unique_ptr<dd::Package<Config>>& sliceDD, unsigned int splitQubit,
-    size_t controls) {
-  Slice lower(sliceDD, 0, splitQubit - 1, controls);
-  Slice upper(
-      sliceDD, splitQubit,
-      static_cast<qc::Qubit>(CircuitSimulator<Config>::getNumberOfQubits() - 1),
-      controls);
+qc::Qubit HybridSchrodingerFeynmanSimulator<Config>::planSplitQubit() {
+  const auto nqubits =
+      static_cast<qc::Qubit>(CircuitSimulator<Config>::getNumberOfQubits());
+  auto best = static_cast<qc::Qubit>(nqubits / 2);
+  auto bestCost = std::numeric_limits<double>::infinity();
 
-  for (const auto& op : *CircuitSimulator<Config>::qc) {
-    assert(op->isUnitary());
-    [[maybe_unused]] auto l = lower.apply(sliceDD, op);
-    [[maybe_unused]] auto u = upper.apply(sliceDD, op);
-    assert(l == u);
-    sliceDD->garbageCollect();
+  // combining the slices of a path into the final result
+  const auto combineCost = mode == Mode::Amplitude
+                               ? std::exp2(static_cast<double>(nqubits))
+                               : static_cast<double>(nqubits);
+
+  // gates acting alike on several candidate cuts are only decomposed once
+  DecompositionPackages packages;
+  for (qc::Qubit candidate = 1; candidate < nqubits; ++candidate) {
+    std::size_t decisions = 0;
+    try {
+      decisions = countDecisions({candidate}, packages);
+    } catch (const std::invalid_argument&) {
+      // the cut would go through a gate that cannot be cut
+      continue;
+    }
+    const auto pathCost = estimateSliceCost(0, candidate - 1) +
+                          estimateSliceCost(candidate, nqubits - 1) +
+                          combineCost;
+    const auto cost = std::ldexp(pathCost, static_cast<int>(decisions));
+    if (cost < bestCost) {
+      bestCost = cost;
+      best = candidate;
+    }
+  }
+  return best;
+}
+
+template <class Config>
+std::vector<typename HybridSchrodingerFeynmanSimulator<Config>::Slice>
+HybridSchrodingerFeynmanSimulator<Config>::makeSlices(
+    std::unique_ptr<dd::Package<Config>>& sliceDD,
+    const std::vector<qc::Qubit>& splitQubits,
+    const std::vector<qc::VectorDD>& edges) {
+  const auto nqubits =
+      static_cast<qc::Qubit>(CircuitSimulator<Config>::getNumberOfQubits());
+  std::vector<Slice> slices;
+  slices.reserve(splitQubits.size() + 1);
+  qc::Qubit start = 0;
+  for (std::size_t i = 0; i <= splitQubits.size(); ++i) {
+    const auto end = i < splitQubits.size() ? splitQubits[i] - 1 : nqubits - 1;
+    if (edges.empty()) {
+      slices.emplace_back(sliceDD, start, end);
+    } else {
+      slices.emplace_back(sliceDD, edges.at(i), start, end);
+    }
+    start = end + 1;
+  }
+  return slices;
+}
+
+template <class Config>
+std::size_t HybridSchrodingerFeynmanSimulator<Config>::applyToSlices(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+    std::vector<Slice>& slices, const std::unique_ptr<qc::Operation>& op,
+    const std::size_t controls) {
+  assert(op->isUnitary());
+  ++appliedOperations;
+
+  if (const auto it = cutDecompositions.find(op.get());
+      it != cutDecompositions.end()) {
+    const auto& decomposition = it->second;
+    const auto term = controls & ((1ULL << decomposition.bits) - 1);
+    applyCutTerm(sliceDD, termDDs, slices, decomposition, term);
+    return decomposition.bits;
+  }
+
+  const bool control = (controls & 1U) != 0U;
+  std::size_t splitSlices = 0;
+  for (auto& slice : slices) {
+    if (slice.apply(sliceDD, op, control)) {
+      ++splitSlices;
+    }
+  }
+  assert(splitSlices == 0 || splitSlices == 2);
+  return splitSlices > 0 ? 1 : 0;
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::applyCutTerm(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+    std::vector<Slice>& slices, const CutDecomposition& decomposition,
+    const std::size_t term) {
+  const auto sliceContaining = [&slices](const qc::Qubit qubit) -> Slice& {
+    return *std::find_if(slices.begin(), slices.end(), [qubit](const auto& s) {
+      return s.start <= qubit && qubit <= s.end;
+    });
+  };
+  auto& lowerSlice = sliceContaining(decomposition.lowerQubits.front());
+  auto& upperSlice = sliceContaining(decomposition.upperQubits.front());
+
+  if (term >= decomposition.lower.size()) {
+    // the decision bits allow more terms than the rank of the gate
+    sliceDD->decRef(lowerSlice.edge);
+    lowerSlice.edge = qc::VectorDD::zero();
+  } else {
+    // the DDs of the terms are built once per package and reused by all
+    // paths taking the same term
+    auto& terms = termDDs[&decomposition];
+    terms.resize(decomposition.lower.size());
+    if (!terms[term]) {
+      terms[term] = {makeMatrixDD(sliceDD, decomposition.lower[term],
+                                  decomposition.lowerQubits),
+                     makeMatrixDD(sliceDD, decomposition.upper[term],
+                                  decomposition.upperQubits)};
+      sliceDD->incRef(terms[term]->first);
+      sliceDD->incRef(terms[term]->second);
+    }
+    for (auto* slice : {&lowerSlice, &upperSlice}) {
+      const auto& gate =
+          slice == &lowerSlice ? terms[term]->first : terms[term]->second;
+      auto tmp = slice->edge;
+      slice->edge = sliceDD->multiply(gate, slice->edge);
+      sliceDD->incRef(slice->edge);
+      sliceDD->decRef(tmp);
+    }
   }
+}
+
+template <class Config>
+qc::MatrixDD HybridSchrodingerFeynmanSimulator<Config>::makeMatrixDD(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, const dd::CMat& matrix,
+    const std::vector<qc::Qubit>& qubits) {
+  // sum of the matrix' entries, each being a tensor product of single-qubit
+  // matrices with a single non-zero entry
+  auto result = qc::MatrixDD::zero();
+  for (std::size_t row = 0; row < matrix.size(); ++row) {
+    for (std::size_t col = 0; col < matrix[row].size(); ++col) {
+      const auto value = matrix[row][col];
+      if (std::abs(value) < 1e-12) {
+        continue;
+      }
+      auto entry = qc::MatrixDD::zero();
+      for (std::size_t i = 0; i < qubits.size(); ++i) {
+        const auto factorValue = i == 0 ? value : std::complex<dd::fp>{1., 0.};
+        dd::GateMatrix factor{};
+        factor[(2 * ((row >> i) & 1U)) + ((col >> i) & 1U)] = {
+            factorValue.real(), factorValue.imag()};
+        const auto factorDD =
+            sliceDD->makeGateDD(factor, static_cast<dd::Qubit>(qubits[i]));
+        entry = i == 0 ? factorDD : sliceDD->multiply(entry, factorDD);
+      }
+      result = sliceDD->add(result, entry);
+    }
+  }
+  return result;
+}
 
-  auto result =
-      sliceDD->kronecker(upper.edge, lower.edge, lower.nqubits, false);
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::releaseTermDDs(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs) {
+  for (const auto& [decomposition, terms] : termDDs) {
+    for (const auto& term : terms) {
+      if (term) {
+        sliceDD->decRef(term->first);
+        sliceDD->decRef(term->second);
+      }
+    }
+  }
+  termDDs.clear();
+}
+
+template <class Config>
+qc::VectorDD HybridSchrodingerFeynmanSimulator<Config>::combineSlices(
+    std::unique_ptr<dd::Package<Config>>& sliceDD,
+    const std::vector<Slice>& slices) {
+  auto result = slices.front().edge;
+  qc::Qubit lowerQubits = slices.front().nqubits;
+  for (std::size_t i = 1; i < slices.size(); ++i) {
+    result = sliceDD->kronecker(slices[i].edge, result, lowerQubits, false);
+    lowerQubits += slices[i].nqubits;
+  }
   sliceDD->incRef(result);
+  return result;
+}
+
+template <class Config>
+std::vector<typename HybridSchrodingerFeynmanSimulator<Config>::Slice>
+HybridSchrodingerFeynmanSimulator<Config>::simulateSlices(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+    const std::vector<qc::Qubit>& splitQubits, std::size_t controls) {
+  auto slices = makeSlices(sliceDD, splitQubits);
+
+  auto gcPolicy = Simulator<Config>::gcPolicy.clone();
+  std::size_t decision = 0;
+  for (const auto& op : *CircuitSimulator<Config>::qc) {
+    // every cut gate consumes the next bits of the control value, which
+    // select the term of its decomposition
+    decision +=
+        applyToSlices(sliceDD, termDDs, slices, op, controls >> decision);
+    gcPolicy.maybeCollect(*sliceDD);
+  }
+  {
+    const std::lock_guard<std::mutex> lock(gcStatisticsMutex);
+    Simulator<Config>::gcPolicy.mergeStatistics(gcPolicy);
+  }
+  return slices;
+}
 
+template <class Config>
+qc::VectorDD HybridSchrodingerFeynmanSimulator<Config>::simulateSlicing(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+    const std::vector<qc::Qubit>& splitQubits, std::size_t controls) {
+  const auto slices = simulateSlices(sliceDD, termDDs, splitQubits, controls);
+  const auto result = combineSlices(sliceDD, slices);
+  // the package may be used for further paths
+  for (const auto& slice : slices) {
+    sliceDD->decRef(slice.edge);
+  }
   return result;
 }
 
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::simulateDecisionTree(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+    const std::vector<qc::Qubit>& splitQubits,
+    std::vector<std::size_t> controls,
+    const std::function<void(const qc::VectorDD&)>& onPath) {
+  traverseDecisionTree(sliceDD, termDDs, splitQubits, std::move(controls),
+                       [this, &sliceDD,
+                        &onPath](const std::vector<Slice>& slices) {
+                         const auto result = combineSlices(sliceDD, slices);
+                         onPath(result);
+                         sliceDD->decRef(result);
+                       });
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::traverseDecisionTree(
+    std::unique_ptr<dd::Package<Config>>& sliceDD, TermDDs& termDDs,
+    const std::vector<qc::Qubit>& splitQubits,
+    std::vector<std::size_t> controls,
+    const std::function<void(const std::vector<Slice>&)>& onSlices) {
+  struct Checkpoint {
+    // index of the next operation and of the next decision
+    std::size_t op;
+    std::size_t decision;
+    // states of the slices (starting from the zero state if empty)
+    std::vector<qc::VectorDD> edges;
+    // control values of the paths continuing from here
+    std::vector<std::size_t> controls;
+  };
+
+  const auto& qc = CircuitSimulator<Config>::qc;
+  const auto nops = qc->getNops();
+  auto gcPolicy = Simulator<Config>::gcPolicy.clone();
+
+  std::vector<Checkpoint> stack;
+  stack.push_back({0, 0, {}, std::move(controls)});
+  std::size_t heldCheckpoints = 0;
+  while (!stack.empty()) {
+    auto current = std::move(stack.back());
+    stack.pop_back();
+
+    auto slices = makeSlices(sliceDD, splitQubits, current.edges);
+    if (!current.edges.empty()) {
+      // the slices hold their own references now
+      for (auto& edge : current.edges) {
+        sliceDD->decRef(edge);
+      }
+      --heldCheckpoints;
+    }
+
+    auto& paths = current.controls;
+    auto decision = current.decision;
+    for (auto i = current.op; i < nops; ++i) {
+      const auto& op = qc->at(i);
+      if (const auto bits = decisionBits(*op, splitQubits); bits > 0) {
+        const auto mask = (1ULL << bits) - 1;
+        const auto byTerm = [decision, mask](const std::size_t lhs,
+                                             const std::size_t rhs) {
+          return ((lhs >> decision) & mask) < ((rhs >> decision) & mask);
+        };
+        std::stable_sort(paths.begin(), paths.end(), byTerm);
+        // the paths taking another term of the decomposition branch off here
+        const auto taken =
+            std::upper_bound(paths.begin(), paths.end(), paths.front(), byTerm);
+        for (auto first = taken; first != paths.end();) {
+          const auto last =
+              std::upper_bound(first, paths.end(), *first, byTerm);
+          Checkpoint branch{i, decision, {}, {first, last}};
+          if (heldCheckpoints < maxCheckpoints) {
+            for (const auto& slice : slices) {
+              sliceDD->incRef(slice.edge);
+              branch.edges.emplace_back(slice.edge);
+            }
+            ++heldCheckpoints;
+          } else {
+            // replay the branch from the beginning of the circuit
+            branch.op = 0;
+            branch.decision = 0;
+          }
+          stack.emplace_back(std::move(branch));
+          first = last;
+        }
+        paths.erase(taken, paths.end());
+      }
+      // all remaining paths agree on the decisions made so far
+      decision += applyToSlices(sliceDD, termDDs, slices, op,
+                                paths.front() >> decision);
+      gcPolicy.maybeCollect(*sliceDD);
+    }
+    assert(paths.size() == 1);
+
+    onSlices(slices);
+    for (const auto& slice : slices) {
+      sliceDD->decRef(slice.edge);
+    }
+    gcPolicy.maybeCollect(*sliceDD);
+  }
+
+  const std::lock_guard<std::mutex> lock(gcStatisticsMutex);
+  Simulator<Config>::gcPolicy.mergeStatistics(gcPolicy);
+}
+
 template <class Config>
 bool HybridSchrodingerFeynmanSimulator<Config>::Slice::apply(
     std::unique_ptr<dd::Package<Config>>& sliceDD,
-    const std::unique_ptr<qc::Operation>& op) {
+    const std::unique_ptr<qc::Operation>& op, const bool control) {
   bool isSplitOp = false;
   assert(op->isStandardOperation());
   qc::Targets opTargets{};
@@ -137,21 +739,19 @@ bool HybridSchrodingerFeynmanSimulator<Config>::Slice::apply(
     }
   }
 
-  // Ensured in the getNDecisions function
+  // Ensured in the decomposeCut function
   assert(!(targetInSplit && targetInOtherSplit));
 
   // check controls
-  for (const auto& control : op->getControls()) {
-    if (start <= control.qubit && control.qubit <= end) {
-      opControls.emplace(control);
+  for (const auto& c : op->getControls()) {
+    if (start <= c.qubit && c.qubit <= end) {
+      opControls.emplace(c);
     } else { // other controls are set to the corresponding value
       if (targetInSplit) {
         isSplitOp = true;
-        const bool nextControl = getNextControl();
         // break if control is not activated
-        if ((control.type == qc::Control::Type::Pos && !nextControl) ||
-            (control.type == qc::Control::Type::Neg && nextControl)) {
-          nDecisionsExecuted++;
+        if ((c.type == qc::Control::Type::Pos && !control) ||
+            (c.type == qc::Control::Type::Neg && control)) {
           return true;
         }
       }
@@ -159,11 +759,10 @@ bool HybridSchrodingerFeynmanSimulator<Config>::Slice::apply(
   }
 
   if (targetInOtherSplit && !opControls.empty()) { // control slice for split
-    // Ensured in the getNDecisions function
+    // Ensured in the decomposeCut function
     assert(opControls.size() == 1);
 
     isSplitOp = true;
-    const bool control = getNextControl();
     for (const auto& c : opControls) {
       auto tmp = edge;
       edge = sliceDD->deleteEdge(
@@ -182,15 +781,18 @@ bool HybridSchrodingerFeynmanSimulator<Config>::Slice::apply(
     sliceDD->decRef(tmp);
   }
 
-  if (isSplitOp) {
-    nDecisionsExecuted++;
-  }
   return isSplitOp;
 }
 
 template <class Config>
 std::map<std::string, std::size_t>
 HybridSchrodingerFeynmanSimulator<Config>::simulate(std::size_t shots) {
+  return toStringHistogram(simulateCompact(shots),
+                           CircuitSimulator<Config>::getNumberOfQubits());
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::checkSupportedCircuit() const {
   if (CircuitSimulator<Config>::qc->isDynamic()) {
     throw std::invalid_argument(
         "Dynamic quantum circuits containing mid-circuit measurements, resets, "
@@ -204,27 +806,156 @@ HybridSchrodingerFeynmanSimulator<Config>::simulate(std::size_t shots) {
                                   op->getName() + "\" is not supported.");
     }
   }
+}
 
+template <class Config>
+std::vector<qc::Qubit>
+HybridSchrodingerFeynmanSimulator<Config>::prepareCuts() {
   auto nqubits = CircuitSimulator<Config>::getNumberOfQubits();
-  auto splitQubit = static_cast<qc::Qubit>(nqubits / 2);
+  auto cuts = splitQubits;
+  if (cuts.empty()) {
+    cuts.emplace_back(automaticSplit ? planSplitQubit()
+                                     : static_cast<qc::Qubit>(nqubits / 2));
+  }
+  usedSplitQubits = cuts;
+  cutDecompositions.clear();
+  usedDecisions = 0;
+  DecompositionPackages packages;
+  for (const auto& op : *CircuitSimulator<Config>::qc) {
+    if (auto operands = cutOperands(*op, cuts)) {
+      auto decomposition =
+          decomposeCut(*op, operands->first, operands->second, packages);
+      decomposition.lowerQubits = std::move(operands->first);
+      decomposition.upperQubits = std::move(operands->second);
+      usedDecisions += decomposition.bits;
+      cutDecompositions.emplace(op.get(), std::move(decomposition));
+    } else {
+      usedDecisions += countCutControls(*op, cuts);
+    }
+  }
+  appliedOperations = 0;
+  return cuts;
+}
+
+template <class Config>
+std::size_t HybridSchrodingerFeynmanSimulator<Config>::decisionBits(
+    const qc::Operation& op, const std::vector<qc::Qubit>& splitQubits) const {
+  if (const auto it = cutDecompositions.find(&op);
+      it != cutDecompositions.end()) {
+    return it->second.bits;
+  }
+  return countCutControls(op, splitQubits);
+}
+
+template <class Config>
+PackedHistogram
+HybridSchrodingerFeynmanSimulator<Config>::simulateCompact(std::size_t shots) {
+  checkSupportedCircuit();
+
+  const auto cuts = prepareCuts();
+  if (nprocesses > 1) {
+    simulateDistributed(cuts);
+  } else if (mode == Mode::DD) {
+    simulateHybridTaskflow(cuts);
+  } else {
+    simulateHybridAmplitudes(cuts);
+  }
   if (mode == Mode::DD) {
-    simulateHybridTaskflow(splitQubit);
-    return CircuitSimulator<Config>::measureAllNonCollapsing(shots);
+    return Simulator<Config>::measureAllNonCollapsingCompact(shots);
   }
-  simulateHybridAmplitudes(splitQubit);
 
   if (shots > 0) {
-    return Simulator<Config>::sampleFromAmplitudeVectorInPlace(finalAmplitudes,
-                                                               shots);
+    return Simulator<Config>::sampleFromAmplitudeVectorInPlaceCompact(
+        finalAmplitudes, shots);
   }
   // in case no shots were requested, the final amplitudes remain untouched
   return {};
 }
 
+template <class Config>
+std::vector<std::complex<dd::fp>>
+HybridSchrodingerFeynmanSimulator<Config>::getAmplitudes(
+    const std::vector<std::string>& bitstrings) {
+  checkSupportedCircuit();
+  const auto nqubits = CircuitSimulator<Config>::getNumberOfQubits();
+  for (const auto& bitstring : bitstrings) {
+    if (bitstring.size() != nqubits ||
+        bitstring.find_first_not_of("01") != std::string::npos) {
+      throw std::invalid_argument("Invalid bitstring \"" + bitstring +
+                                  "\" for a circuit with " +
+                                  std::to_string(nqubits) + " qubits.");
+    }
+  }
+
+  const auto cuts = prepareCuts();
+  const auto ndecisions = usedDecisions;
+  const auto maxControl = 1ULL << ndecisions;
+  const auto actuallyUsedThreads = std::min<std::size_t>(maxControl, nthreads);
+  const auto chunkSize = static_cast<std::size_t>(
+      std::ceil(static_cast<double>(maxControl) /
+                static_cast<double>(actuallyUsedThreads)));
+  const auto nslicesOnOneCpu = std::min<std::size_t>(64, chunkSize);
+  const auto nchunks = static_cast<std::size_t>(std::ceil(
+      static_cast<double>(maxControl) / static_cast<double>(nslicesOnOneCpu)));
+
+  // the amplitudes of every path are the products of the slices' amplitudes,
+  // so neither the combined DD nor a dense vector is ever constructed
+  tf::Executor executor(actuallyUsedThreads);
+  // every worker thread accumulates the amplitudes of all of its chunks
+  std::vector<std::vector<std::complex<dd::fp>>> partialAmplitudes(
+      executor.num_workers(),
+      std::vector<std::complex<dd::fp>>(bitstrings.size()));
+  for (std::size_t i = 0; i < nchunks; ++i) {
+    executor.silent_async([this, i, &executor, &partialAmplitudes, &bitstrings,
+                           &cuts, nslicesOnOneCpu, maxControl, ndecisions]() {
+      auto& amplitudes = partialAmplitudes[static_cast<std::size_t>(
+          executor.this_worker_id())];
+      const auto accumulate = [&amplitudes,
+                               &bitstrings](const std::vector<Slice>& slices) {
+        for (std::size_t j = 0; j < bitstrings.size(); ++j) {
+          std::complex<dd::fp> amplitude{1., 0.};
+          for (const auto& slice : slices) {
+            amplitude *= amplitudeOf(slice.edge, bitstrings[j]);
+          }
+          amplitudes[j] += amplitude;
+        }
+      };
+
+      auto sliceDD = std::make_unique<dd::Package<Config>>(
+          CircuitSimulator<Config>::getNumberOfQubits());
+      TermDDs termDDs;
+      const auto first = i * nslicesOnOneCpu;
+      const auto npaths =
+          std::min<std::size_t>(nslicesOnOneCpu, maxControl - first);
+      if (prefixSharing) {
+        traverseDecisionTree(sliceDD, termDDs, cuts,
+                             treeControls(first, npaths, ndecisions),
+                             accumulate);
+        return;
+      }
+      for (auto control = first; control < first + npaths; ++control) {
+        const auto slices = simulateSlices(sliceDD, termDDs, cuts, control);
+        accumulate(slices);
+        for (const auto& slice : slices) {
+          sliceDD->decRef(slice.edge);
+        }
+      }
+    });
+  }
+  executor.wait_for_all();
+
+  auto result = std::move(partialAmplitudes.front());
+  for (std::size_t i = 1; i < partialAmplitudes.size(); ++i) {
+    std::transform(result.begin(), result.end(), partialAmplitudes[i].begin(),
+                   result.begin(), std::plus<>());
+  }
+  return result;
+}
+
 template <class Config>
 void HybridSchrodingerFeynmanSimulator<Config>::simulateHybridTaskflow(
-    unsigned int splitQubit) {
-  const auto ndecisions = getNDecisions(splitQubit);
+    const std::vector<qc::Qubit>& splitQubits) {
+  const auto ndecisions = usedDecisions;
   const auto maxControl = 1ULL << ndecisions;
   const auto actuallyUsedThreads = std::min<std::size_t>(maxControl, nthreads);
   const auto chunkSize = static_cast<std::size_t>(
@@ -234,120 +965,392 @@ void HybridSchrodingerFeynmanSimulator<Config>::simulateHybridTaskflow(
   const auto nqubits = CircuitSimulator<Config>::getNumberOfQubits();
   const auto nresults = static_cast<std::size_t>(std::ceil(
       static_cast<double>(maxControl) / static_cast<double>(nslicesOnOneCpu)));
-  const auto lastLevel =
-      static_cast<std::size_t>(std::ceil(std::log2(nresults)));
   Simulator<Config>::rootEdge = qc::VectorDD::zero();
+  spilledResults = 0;
+  residentNodes = 0;
+  residentPartials = 0;
+  // every resident partial keeps a whole package alive, so with a threshold
+  // set, only as many partials as there are threads stay in memory
+  maxResidentPartials =
+      spillThreshold == std::numeric_limits<std::size_t>::max()
+          ? std::numeric_limits<std::size_t>::max()
+          : actuallyUsedThreads;
 
-  std::vector<std::vector<bool>> computed(ndecisions,
-                                          std::vector<bool>(maxControl, false));
-
-  tf::Executor executor(actuallyUsedThreads);
+  std::vector<PartialResult> partials(nresults);
+  // computed[level][index] is set once the partial of the given node of the
+  // reduction tree is available, i.e., partials[index << level]
+  std::vector<std::vector<bool>> computed;
+  for (std::size_t count = nresults; count > 1; count = (count + 1) / 2) {
+    computed.emplace_back(count, false);
+  }
+  std::mutex computedMutex;
 
-  std::function<void(std::pair<std::size_t, std::size_t>)> computePair =
-      [this, &computePair, &computed, &executor, nslicesOnOneCpu, splitQubit,
-       maxControl, nqubits,
-       lastLevel](std::pair<std::size_t, std::size_t> current) {
-        if (current.first == 0) { // slice
-          std::unique_ptr<dd::Package<Config>> oldDD;
-          qc::VectorDD edge{};
-          for (std::size_t i = 0; i < nslicesOnOneCpu; ++i) {
-            const auto totalControl = current.second + i;
-            if (totalControl >= maxControl) {
-              break;
-            }
-            auto sliceDD = std::make_unique<dd::Package<Config>>(nqubits);
-            auto result = simulateSlicing(sliceDD, splitQubit, totalControl);
-            if (i > 0) {
-              edge = sliceDD->add(sliceDD->transfer(edge), result);
-            } else {
-              edge = result;
-            }
-            oldDD = std::move(
-                sliceDD); // this might seem unused, but it keeps the DD package
-                          // alive for the serialization below
-          }
-          dd::serialize(edge,
-                        "slice_" + std::to_string(current.first) + "_" +
-                            std::to_string(current.second) + ".dd",
-                        true);
-        } else { // adding
-          const std::string filename =
-              "slice_" + std::to_string(current.first - 1) + "_";
-          const std::string filenameLeft =
-              filename + std::to_string(current.second) + ".dd";
-          const auto offset = (1ULL << (current.first - 1)) * nslicesOnOneCpu;
-          const auto idx = current.second + offset;
-          if (idx >= maxControl) {
+  // add the finished partial to its sibling as soon as both are available
+  // instead of waiting for the whole level of the reduction tree
+  const auto computePair = [this, &partials, &computed,
+                            &computedMutex](std::size_t level,
+                                            std::size_t index) {
+    while (level < computed.size()) {
+      // a partial without a sibling is promoted to the next level unchanged
+      if (const auto sibling = index ^ 1U; sibling < computed[level].size()) {
+        {
+          const std::lock_guard<std::mutex> lock(computedMutex);
+          if (!computed[level][sibling]) {
+            computed[level][index] = true;
             return;
           }
-          const std::string filenameRight =
-              filename + std::to_string(idx) + ".dd";
-
-          auto sliceDD = std::make_unique<dd::Package<Config>>(nqubits);
-          auto result =
-              sliceDD->template deserialize<dd::vNode>(filenameLeft, true);
-          auto result2 =
-              sliceDD->template deserialize<dd::vNode>(filenameRight, true);
-          result = sliceDD->add(result, result2);
-          dd::serialize(result,
-                        "slice_" + std::to_string(current.first) + "_" +
-                            std::to_string(current.second) + ".dd",
-                        true);
-
-          std::remove(filenameLeft.c_str());
-          std::remove(filenameRight.c_str());
         }
+        reducePartials(partials[std::min(index, sibling) << level],
+                       partials[std::max(index, sibling) << level]);
+      }
+      ++level;
+      index /= 2;
+    }
+  };
 
-        if (current.first < lastLevel) {
-          computed.at(current.first).at(current.second) = true;
-
-          auto offset = (1ULL << current.first) * nslicesOnOneCpu;
-          auto chunk = current.second / offset;
-          auto secondResult = (chunk % 2 == 0) ? (current.second + offset)
-                                               : (current.second - offset);
-          if (secondResult >= maxControl) {
-            // lonely result, promote to next level
-            const auto filename = "slice_" + std::to_string(current.first) +
-                                  "_" + std::to_string(current.second) + ".dd";
-            const auto newFilename = "slice_" +
-                                     std::to_string(current.first + 1) + "_" +
-                                     std::to_string(current.second) + ".dd";
-            rename(filename.c_str(), newFilename.c_str());
-            current.first += 1;
-            computed.at(current.first).at(current.second) = true;
-            // compute new second result
-            offset *= 2;
-            chunk = current.second / offset;
-            secondResult = (chunk % 2 == 0) ? (current.second + offset)
-                                            : (current.second - offset);
-          }
-          if (computed.at(current.first).at(secondResult)) {
-            current.first += 1;
-            current.second = std::min(current.second,
-                                      static_cast<std::size_t>(secondResult));
-            executor.silent_async(
-                [&computePair, current]() { computePair(current); });
-          }
-        }
+  tf::Executor executor(actuallyUsedThreads);
+  for (std::size_t i = 0; i < nresults; ++i) {
+    executor.silent_async([this, &partials, &computePair, i, nslicesOnOneCpu,
+                           &splitQubits, maxControl, ndecisions, nqubits]() {
+      auto& partial = partials[i];
+      const auto first = i * nslicesOnOneCpu;
+      const auto npaths =
+          std::min<std::size_t>(nslicesOnOneCpu, maxControl - first);
+      partial.package = std::make_unique<dd::Package<Config>>(nqubits);
+      partial.edge = qc::VectorDD::zero();
+      TermDDs termDDs;
+      const auto accumulate = [&partial](const qc::VectorDD& result) {
+        auto sum = partial.package->add(partial.edge, result);
+        partial.package->incRef(sum);
+        partial.package->decRef(partial.edge);
+        partial.edge = sum;
       };
 
-  for (std::uint64_t i = 0U; i < maxControl; i += nslicesOnOneCpu) {
-    executor.silent_async(
-        [&computePair, i]() { computePair(std::make_pair(0, i)); });
+      if (prefixSharing) {
+        simulateDecisionTree(partial.package, termDDs, splitQubits,
+                             treeControls(first, npaths, ndecisions),
+                             accumulate);
+      } else {
+        for (auto control = first; control < first + npaths; ++control) {
+          auto result =
+              simulateSlicing(partial.package, termDDs, splitQubits, control);
+          accumulate(result);
+          partial.package->decRef(result);
+        }
+      }
+      // the package only holds the partial result during the reduction
+      releaseTermDDs(partial.package, termDDs);
+      partial.package->garbageCollect(true);
+      keepOrSpill(partial);
+      computePair(0, i);
+    });
   }
   executor.wait_for_all();
 
-  const auto filename = "slice_" + std::to_string(lastLevel) + "_0.dd";
-  Simulator<Config>::rootEdge =
-      Simulator<Config>::dd->template deserialize<dd::vNode>(filename, true);
+  auto& result = partials.front();
+  restore(result);
+  Simulator<Config>::rootEdge = Simulator<Config>::dd->transfer(result.edge);
   Simulator<Config>::dd->incRef(Simulator<Config>::rootEdge);
-  std::remove(filename.c_str());
+  release(result);
+  removeScratchDirectory();
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::simulateDistributed(
+    const std::vector<qc::Qubit>& splitQubits) {
+  const auto ndecisions = usedDecisions;
+  const auto maxControl = 1ULL << ndecisions;
+  const auto nqubits = CircuitSimulator<Config>::getNumberOfQubits();
+  // every worker process simulates its ranges with `nthreads` threads
+  const auto threadsPerProcess = std::max<std::size_t>(nthreads, 1);
+  // small ranges balance the load, large ranges share more prefixes
+  const auto rangeSize = std::clamp<std::size_t>(
+      maxControl / (4 * nprocesses), threadsPerProcess, 64 * threadsPerProcess);
+
+  // state of a worker process, where every thread accumulates its paths
+  struct ThreadState {
+    std::unique_ptr<dd::Package<Config>> package;
+    TermDDs termDDs;
+    qc::VectorDD edge = qc::VectorDD::zero();
+    dd::CVec amplitudes;
+  };
+  std::vector<ThreadState> threadStates(threadsPerProcess);
+  // with a single amplitude buffer, the threads of a worker process add their
+  // results to the process' copy of the final amplitudes instead
+  const auto sharedAmplitudes =
+      mode == Mode::Amplitude && singleAmplitudeBuffer;
+  std::size_t nstripes = 0;
+  if (sharedAmplitudes) {
+    nstripes = 1;
+    while (nstripes < 16 * threadsPerProcess && nstripes < (1ULL << nqubits)) {
+      nstripes *= 2;
+    }
+  }
+  std::vector<std::mutex> stripes(nstripes);
+  // only created within the worker processes
+  std::unique_ptr<tf::Executor> workerExecutor;
+  const auto simulateRange = [this, &splitQubits, &threadStates, &stripes,
+                              ndecisions, nqubits](const std::size_t thread,
+                                                   const std::size_t first,
+                                                   const std::size_t count) {
+    auto& state = threadStates[thread];
+    if (!state.package) {
+      state.package = std::make_unique<dd::Package<Config>>(nqubits);
+      if (mode == Mode::Amplitude && stripes.empty()) {
+        state.amplitudes.assign(1ULL << nqubits, 0);
+      }
+    }
+    const auto accumulate = [this, &state, &stripes,
+                             thread](const qc::VectorDD& result) {
+      if (mode == Mode::Amplitude && !stripes.empty()) {
+        addToSharedAmplitudes(result, stripes, thread);
+        return;
+      }
+      if (mode == Mode::Amplitude) {
+        result.addToVector(state.amplitudes);
+        return;
+      }
+      auto sum = state.package->add(state.edge, result);
+      state.package->incRef(sum);
+      state.package->decRef(state.edge);
+      state.edge = sum;
+    };
+
+    if (prefixSharing) {
+      simulateDecisionTree(state.package, state.termDDs, splitQubits,
+                           treeControls(first, count, ndecisions), accumulate);
+      return;
+    }
+    for (auto control = first; control < first + count; ++control) {
+      const auto result =
+          simulateSlicing(state.package, state.termDDs, splitQubits, control);
+      accumulate(result);
+      state.package->decRef(result);
+    }
+  };
+  const auto process = [&workerExecutor, &simulateRange,
+                        threadsPerProcess](const std::size_t first,
+                                           const std::size_t count) {
+    const auto nchunks = std::min(count, threadsPerProcess);
+    if (nchunks == 1) {
+      simulateRange(0, first, count);
+      return;
+    }
+    if (!workerExecutor) {
+      workerExecutor = std::make_unique<tf::Executor>(threadsPerProcess);
+    }
+    const auto chunkSize = (count + nchunks - 1) / nchunks;
+    for (std::size_t i = 0; i < nchunks; ++i) {
+      const auto chunkFirst = first + (i * chunkSize);
+      const auto chunkEnd = std::min(first + count, chunkFirst + chunkSize);
+      if (chunkFirst >= chunkEnd) {
+        break;
+      }
+      workerExecutor->silent_async([&simulateRange, i, chunkFirst, chunkEnd]() {
+        simulateRange(i, chunkFirst, chunkEnd - chunkFirst);
+      });
+    }
+    workerExecutor->wait_for_all();
+  };
+
+  // the number of applied operations followed by the amplitudes or the
+  // serialized DD (both omitted if the worker did not get any paths)
+  const auto finish = [this, &threadStates, sharedAmplitudes]() {
+    // combine the results of the worker's threads
+    ThreadState* combined = nullptr;
+    for (auto& state : threadStates) {
+      if (!state.package) {
+        continue;
+      }
+      if (combined == nullptr) {
+        combined = &state;
+        continue;
+      }
+      if (mode == Mode::Amplitude) {
+        if (!sharedAmplitudes) {
+          std::transform(combined->amplitudes.begin(),
+                         combined->amplitudes.end(), state.amplitudes.begin(),
+                         combined->amplitudes.begin(), std::plus<>());
+          dd::CVec().swap(state.amplitudes);
+        }
+        continue;
+      }
+      const auto edge = combined->package->transfer(state.edge);
+      auto sum = combined->package->add(combined->edge, edge);
+      combined->package->incRef(sum);
+      combined->package->decRef(combined->edge);
+      combined->edge = sum;
+    }
+
+    std::string result;
+    const auto applied = static_cast<std::uint64_t>(appliedOperations);
+    if (combined == nullptr) {
+      result.assign(reinterpret_cast<const char*>(&applied), sizeof(applied));
+      return result;
+    }
+    if (mode == Mode::Amplitude) {
+      // written into the result directly to avoid another copy of the
+      // amplitudes
+      const auto& amplitudes =
+          sharedAmplitudes ? finalAmplitudes : combined->amplitudes;
+      const auto size = amplitudes.size() * sizeof(std::complex<dd::fp>);
+      result.reserve(sizeof(applied) + size);
+      result.append(reinterpret_cast<const char*>(&applied), sizeof(applied));
+      result.append(reinterpret_cast<const char*>(amplitudes.data()), size);
+      return result;
+    }
+    std::ostringstream os(std::ios::binary);
+    os.write(reinterpret_cast<const char*>(&applied), sizeof(applied));
+    dd::serialize(combined->edge, os, true);
+    return os.str();
+  };
+
+  auto& dd = Simulator<Config>::dd;
+  auto& rootEdge = Simulator<Config>::rootEdge;
+  rootEdge = qc::VectorDD::zero();
+  if (mode == Mode::Amplitude) {
+    finalAmplitudes.assign(1ULL << nqubits, 0);
+  }
+  std::size_t applied = 0;
+  const auto collect = [this, &dd, &rootEdge, &applied](std::string&& result) {
+    std::uint64_t workerApplied = 0;
+    std::memcpy(&workerApplied, result.data(), sizeof(workerApplied));
+    applied += workerApplied;
+    if (result.size() == sizeof(workerApplied)) {
+      return;
+    }
+
+    if (mode == Mode::Amplitude) {
+      const auto* data = result.data() + sizeof(workerApplied);
+      for (auto& amplitude : finalAmplitudes) {
+        std::complex<dd::fp> value{};
+        std::memcpy(&value, data, sizeof(value));
+        amplitude += value;
+        data += sizeof(value);
+      }
+      return;
+    }
+    std::istringstream is(result.substr(sizeof(workerApplied)),
+                          std::ios::binary);
+    const auto edge = dd->template deserialize<dd::vNode>(is, true);
+    auto sum = dd->add(rootEdge, edge);
+    dd->incRef(sum);
+    dd->decRef(rootEdge);
+    rootEdge = sum;
+  };
+
+  WorkerPool(nprocesses).run(maxControl, rangeSize, process, finish, collect);
+  appliedOperations = applied;
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::keepOrSpill(
+    PartialResult& partial) {
+  const auto nodes = partial.edge.size();
+  if (residentPartials.fetch_add(1) < maxResidentPartials) {
+    if (residentNodes.fetch_add(nodes) + nodes <= spillThreshold) {
+      partial.nodes = nodes;
+      partial.resident = true;
+      return;
+    }
+    residentNodes -= nodes;
+  }
+  --residentPartials;
+
+  partial.file = nextScratchFile();
+  dd::serialize(partial.edge, partial.file, true);
+  partial.package.reset();
+  partial.edge = qc::VectorDD::zero();
+  partial.nodes = 0;
+  ++spilledResults;
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::restore(
+    PartialResult& partial) {
+  if (partial.file.empty()) {
+    return;
+  }
+  partial.package = std::make_unique<dd::Package<Config>>(
+      CircuitSimulator<Config>::getNumberOfQubits());
+  partial.edge =
+      partial.package->template deserialize<dd::vNode>(partial.file, true);
+  partial.package->incRef(partial.edge);
+  std::filesystem::remove(partial.file);
+  partial.file.clear();
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::release(
+    PartialResult& partial) {
+  residentNodes -= partial.nodes;
+  if (partial.resident) {
+    --residentPartials;
+  }
+  partial.nodes = 0;
+  partial.resident = false;
+  partial.edge = qc::VectorDD::zero();
+  partial.package.reset();
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::reducePartials(
+    PartialResult& left, PartialResult& right) {
+  restore(left);
+  restore(right);
+
+  auto& package = left.package;
+  auto sum = package->add(left.edge, package->transfer(right.edge));
+  package->incRef(sum);
+  package->decRef(left.edge);
+  release(right);
+
+  residentNodes -= left.nodes;
+  if (left.resident) {
+    --residentPartials;
+  }
+  left.nodes = 0;
+  left.resident = false;
+  left.edge = sum;
+  package->garbageCollect(true);
+  keepOrSpill(left);
+}
+
+template <class Config>
+std::string HybridSchrodingerFeynmanSimulator<Config>::nextScratchFile() {
+  const std::lock_guard<std::mutex> lock(scratchMutex);
+  if (scratchPath.empty()) {
+    const auto base = scratchDirectory.empty()
+                          ? std::filesystem::temp_directory_path()
+                          : std::filesystem::path(scratchDirectory);
+    std::filesystem::create_directories(base);
+    // a name that is unique across concurrent jobs sharing the directory
+    std::random_device rd;
+    std::filesystem::path path;
+    do {
+      path = base / ("ddsim_hsf_" + std::to_string(rd()) + "_" +
+                     std::to_string(rd()));
+    } while (!std::filesystem::create_directory(path));
+    scratchPath = path.string();
+  }
+  return (std::filesystem::path(scratchPath) /
+          ("partial_" + std::to_string(scratchFiles++) + ".dd"))
+      .string();
+}
+
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::removeScratchDirectory() {
+  if (!scratchPath.empty()) {
+    std::filesystem::remove_all(scratchPath);
+    scratchPath.clear();
+    scratchFiles = 0;
+  }
 }
 
 template <class Config>
 void HybridSchrodingerFeynmanSimulator<Config>::simulateHybridAmplitudes(
-    qc::Qubit splitQubit) {
-  const auto ndecisions = getNDecisions(splitQubit);
+    const std::vector<qc::Qubit>& splitQubits) {
+  const auto ndecisions = usedDecisions;
   const auto maxControl = 1ULL << ndecisions;
   const auto actuallyUsedThreads = std::min<std::size_t>(maxControl, nthreads);
   const auto chunkSize = static_cast<std::size_t>(
@@ -359,17 +1362,51 @@ void HybridSchrodingerFeynmanSimulator<Config>::simulateHybridAmplitudes(
       static_cast<double>(maxControl) / static_cast<double>(nslicesOnOneCpu)));
   Simulator<Config>::rootEdge = qc::VectorDD::zero();
 
-  std::vector<dd::CVec> amplitudes(requiredVectors,
-                                   dd::CVec(1ULL << nqubits, 0));
+  // the shared buffer is split into stripes of consecutive amplitudes, i.e.,
+  // by the values of the highest qubits, that are locked individually
+  std::size_t nstripes = 0;
+  if (singleAmplitudeBuffer) {
+    nstripes = 1;
+    while (nstripes < 16 * actuallyUsedThreads &&
+           nstripes < (1ULL << nqubits)) {
+      nstripes *= 2;
+    }
+  }
+  std::vector<std::mutex> stripes(nstripes);
+  std::vector<dd::CVec> amplitudes;
+  if (singleAmplitudeBuffer) {
+    finalAmplitudes.assign(1ULL << nqubits, 0);
+  } else {
+    amplitudes.assign(requiredVectors, dd::CVec(1ULL << nqubits, 0));
+  }
 
   tf::Executor executor(actuallyUsedThreads);
   for (std::size_t control = 0, i = 0; control < maxControl;
        control += nslicesOnOneCpu, i++) {
-    executor.silent_async([this, i, &amplitudes, nslicesOnOneCpu, control,
-                           splitQubit, maxControl]() {
-      const auto currentThread = i;
-      std::vector<std::complex<dd::fp>>& threadAmplitudes =
-          amplitudes.at(currentThread);
+    executor.silent_async([this, i, &amplitudes, &stripes, nslicesOnOneCpu,
+                           control, &splitQubits, maxControl, ndecisions]() {
+      const auto accumulate = [this, i, &amplitudes,
+                               &stripes](const qc::VectorDD& result) {
+        if (stripes.empty()) {
+          result.addToVector(amplitudes.at(i));
+        } else {
+          addToSharedAmplitudes(result, stripes, i);
+        }
+      };
+
+      // all paths of the chunk share the package and, thus, the DDs of the
+      // terms of the cut gates
+      auto sliceDD = std::make_unique<dd::Package<Config>>(
+          CircuitSimulator<Config>::getNumberOfQubits());
+      TermDDs termDDs;
+      if (prefixSharing) {
+        const auto npaths =
+            std::min<std::size_t>(nslicesOnOneCpu, maxControl - control);
+        simulateDecisionTree(sliceDD, termDDs, splitQubits,
+                             treeControls(control, npaths, ndecisions),
+                             accumulate);
+        return;
+      }
 
       for (std::size_t localControl = 0; localControl < nslicesOnOneCpu;
            localControl++) {
@@ -377,16 +1414,20 @@ void HybridSchrodingerFeynmanSimulator<Config>::simulateHybridAmplitudes(
         if (totalControl >= maxControl) {
           break;
         }
-        std::unique_ptr<dd::Package<Config>> sliceDD =
-            std::make_unique<dd::Package<Config>>(
-                CircuitSimulator<Config>::getNumberOfQubits());
-        auto result = simulateSlicing(sliceDD, splitQubit, totalControl);
-        result.addToVector(threadAmplitudes);
+        auto result =
+            simulateSlicing(sliceDD, termDDs, splitQubits, totalControl);
+        accumulate(result);
+        sliceDD->decRef(result);
       }
     });
   }
   executor.wait_for_all();
 
+  if (singleAmplitudeBuffer) {
+    // all results have been added to the final amplitudes directly
+    return;
+  }
+
   std::size_t oldIncrement = 1;
   const auto nAdditionLevels =
       static_cast<std::uint16_t>(std::ceil(std::log2(requiredVectors)));
@@ -404,6 +1445,44 @@ void HybridSchrodingerFeynmanSimulator<Config>::simulateHybridAmplitudes(
   finalAmplitudes = std::move(amplitudes[0]);
 }
 
+template <class Config>
+void HybridSchrodingerFeynmanSimulator<Config>::addToSharedAmplitudes(
+    const qc::VectorDD& result, std::vector<std::mutex>& stripes,
+    const std::size_t worker) {
+  const auto nstripes = stripes.size();
+  const auto stripeSize = finalAmplitudes.size() / nstripes;
+  const auto addStripe = [this, &result, stripeSize](const std::size_t stripe) {
+    addRangeToVector(result, 1., 0, stripe * stripeSize,
+                     (stripe + 1) * stripeSize, finalAmplitudes);
+  };
+
+  // every worker starts at a different stripe and skips stripes that are
+  // currently locked by another worker
+  std::vector<std::size_t> pending(nstripes);
+  for (std::size_t i = 0; i < nstripes; ++i) {
+    pending[i] = (worker + i) % nstripes;
+  }
+  while (!pending.empty()) {
+    std::vector<std::size_t> busy;
+    for (const auto stripe : pending) {
+      const std::unique_lock<std::mutex> lock(stripes[stripe],
+                                              std::try_to_lock);
+      if (lock.owns_lock()) {
+        addStripe(stripe);
+      } else {
+        busy.emplace_back(stripe);
+      }
+    }
+    if (!busy.empty()) {
+      // wait for one of the remaining stripes instead of spinning
+      const std::lock_guard<std::mutex> lock(stripes[busy.front()]);
+      addStripe(busy.front());
+      busy.erase(busy.begin());
+    }
+    pending = std::move(busy);
+  }
+}
+
 template <class Config>
 void HybridSchrodingerFeynmanSimulator<Config>::exportDDtoGraphviz(
     std::ostream& os, const bool colored, const bool edgeLabels,
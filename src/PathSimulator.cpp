@@ -2,6 +2,7 @@
 
 #include "CircuitSimulator.hpp"
 #include "Definitions.hpp"
+#include "PackedBitString.hpp"
 #include "Simulator.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
@@ -9,17 +10,49 @@
 #include "dd/Package.hpp"
 #include "ir/QuantumComputation.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
 
+namespace {
+// number of elements in the union of two sets
+std::size_t unionSize(const std::set<qc::Qubit>& lhs,
+                      const std::set<qc::Qubit>& rhs) {
+  std::size_t common = 0;
+  auto l = lhs.begin();
+  auto r = rhs.begin();
+  while (l != lhs.end() && r != rhs.end()) {
+    if (*l < *r) {
+      ++l;
+    } else if (*r < *l) {
+      ++r;
+    } else {
+      ++common;
+      ++l;
+      ++r;
+    }
+  }
+  return lhs.size() + rhs.size() - common;
+}
+} // namespace
+
 template <class Config>
 PathSimulator<Config>::SimulationPath::SimulationPath(
     std::size_t nleaves_, PathSimulator::SimulationPath::Components components_,
@@ -142,12 +175,34 @@ PathSimulator<Config>::SimulationPath::SimulationPath(
 template <class Config>
 std::map<std::string, std::size_t>
 PathSimulator<Config>::simulate(std::size_t shots) {
+  return toStringHistogram(simulateCompact(shots),
+                           CircuitSimulator<Config>::getNumberOfQubits());
+}
+
+template <class Config>
+PackedHistogram PathSimulator<Config>::simulateCompact(std::size_t shots) {
   if (CircuitSimulator<Config>::qc->isDynamic()) {
     throw std::invalid_argument(
         "Dynamic quantum circuits containing mid-circuit measurements, resets, "
         "or classical control flow are not supported by this simulator.");
   }
 
+  if (adaptive) {
+    simulateAdaptive();
+    return this->measureAllNonCollapsingCompact(shots);
+  }
+
+  if (nthreads > 1) {
+    simulateParallel();
+    return this->measureAllNonCollapsingCompact(shots);
+  }
+
+  if (memoryAwareScheduling) {
+    runMemoryAwareSchedule();
+    clearGateCache();
+    return this->measureAllNonCollapsingCompact(shots);
+  }
+
   // build task graph from simulation path
   constructTaskGraph();
   /// Enable the following statements to generate a .dot file of the resulting
@@ -157,9 +212,43 @@ PathSimulator<Config>::simulate(std::size_t shots) {
 
   // perform simulation
   executor.run(taskflow).wait();
+  clearGateCache();
 
   // measure resulting DD
-  return CircuitSimulator<Config>::measureAllNonCollapsing(shots);
+  return this->measureAllNonCollapsingCompact(shots);
+}
+
+template <class Config>
+bool PathSimulator<Config>::loadFromPathCache(
+    const Configuration& configuration) {
+  const auto& qc = CircuitSimulator<Config>::qc;
+  pathCache.emplace(configuration.pathCache);
+
+  // the seed and the cache location do not influence the generated path
+  auto strategy = configuration;
+  strategy.seed = 0;
+  strategy.pathCache.clear();
+  pathCacheKey = SimulationPathCache::key(*qc, strategy.toString());
+
+  const auto nleaves = qc->getNops() + 1;
+  auto components = pathCache->lookup(pathCacheKey, nleaves);
+  if (!components.has_value()) {
+    return false;
+  }
+  simulationPath =
+      SimulationPath(nleaves, std::move(*components), qc.get(), true);
+  pathFromCache = true;
+  return true;
+}
+
+template <class Config> void PathSimulator<Config>::storeInPathCache() {
+  if (!pathCache.has_value() || simulationPath.components.empty()) {
+    return;
+  }
+  // components are stored in the order determined by the path, so they can
+  // be replayed without reordering
+  pathCache->store(pathCacheKey, simulationPath.nleaves,
+                   simulationPath.components);
 }
 
 template <class Config>
@@ -411,6 +500,129 @@ void PathSimulator<Config>::generateGatecostSimulationPath(
   setSimulationPath(components, true);
 }
 
+template <class Config>
+void PathSimulator<Config>::generateCostModelSimulationPath() {
+  // a contiguous block of leaves that has already been contracted
+  struct Block {
+    std::size_t id;
+    std::set<qc::Qubit> support;
+    std::size_t entanglingGates;
+    bool containsState;
+  };
+
+  const auto& qc = CircuitSimulator<Config>::qc;
+  const auto nqubits = qc->getNqubits();
+
+  // estimated number of nodes of the DD representing a block. Only entangling
+  // gates let the DD grow beyond a single node per qubit, and the width is
+  // bounded by the number of qubits the block acts on.
+  const auto estimateSize = [nqubits](const std::size_t supportSize,
+                                      const std::size_t entanglingGates,
+                                      const bool containsState) {
+    const auto support = containsState ? nqubits : supportSize;
+    const auto maxExponent = containsState
+                                 ? static_cast<double>(supportSize) / 2.
+                                 : 2. * static_cast<double>(support);
+    const auto exponent =
+        std::min(static_cast<double>(entanglingGates), maxExponent);
+    return static_cast<double>(std::max<std::size_t>(support, 1)) *
+           std::exp2(exponent);
+  };
+  const auto blockSize = [&estimateSize](const Block& block) {
+    return estimateSize(block.support.size(), block.entanglingGates,
+                        block.containsState);
+  };
+  const auto mergeCost = [&estimateSize, &blockSize](const Block& left,
+                                                     const Block& right) {
+    // the size of the union suffices, so the merged support is not built
+    const auto supportSize = unionSize(left.support, right.support);
+    return (blockSize(left) * blockSize(right)) +
+           estimateSize(supportSize,
+                        left.entanglingGates + right.entanglingGates,
+                        left.containsState || right.containsState);
+  };
+
+  const auto nblocks = qc->getNops() + 1;
+  std::vector<Block> blocks{};
+  blocks.reserve(nblocks);
+  blocks.push_back(Block{0, {}, 0, true});
+  for (std::size_t i = 0; i < qc->getNops(); ++i) {
+    const auto& op = qc->at(i);
+    Block block{i + 1, {}, 0, false};
+    for (const auto& target : op->getTargets()) {
+      block.support.emplace(target);
+    }
+    for (const auto& control : op->getControls()) {
+      block.support.emplace(control.qubit);
+    }
+    if (block.support.size() > 1) {
+      block.entanglingGates = 1;
+    }
+    blocks.emplace_back(std::move(block));
+  }
+
+  // the blocks form a list in circuit order. Merging a block with its right
+  // neighbor only changes the costs of the pairs next to the merged block, so
+  // the candidate pairs are kept in a priority queue and outdated entries are
+  // discarded lazily. Ties are broken towards the leftmost pair.
+  std::vector<std::size_t> next(nblocks);
+  std::vector<std::size_t> prev(nblocks);
+  std::vector<std::size_t> version(nblocks, 0);
+  for (std::size_t i = 0; i < nblocks; ++i) {
+    next[i] = i + 1;
+    prev[i] = i - 1;
+  }
+  // cost, left block, right block, and versions of both blocks
+  using Candidate = std::tuple<double, std::size_t, std::size_t, std::size_t,
+                               std::size_t>;
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>>
+      candidates;
+  const auto pushCandidate = [&](const std::size_t left) {
+    const auto right = next[left];
+    candidates.emplace(mergeCost(blocks[left], blocks[right]), left, right,
+                       version[left], version[right]);
+  };
+  for (std::size_t i = 0; i + 1 < nblocks; ++i) {
+    pushCandidate(i);
+  }
+
+  typename SimulationPath::Components components{};
+  components.reserve(qc->getNops());
+  std::size_t nextID = nblocks;
+  while (!candidates.empty()) {
+    const auto [cost, left, right, leftVersion, rightVersion] =
+        candidates.top();
+    candidates.pop();
+    if (version[left] != leftVersion || version[right] != rightVersion ||
+        next[left] != right) {
+      continue;
+    }
+
+    // only neighboring blocks are contracted, so the left block always
+    // precedes the right one
+    components.emplace_back(blocks[left].id, blocks[right].id);
+    auto& merged = blocks[left];
+    merged.id = nextID++;
+    merged.support.insert(blocks[right].support.begin(),
+                          blocks[right].support.end());
+    merged.entanglingGates += blocks[right].entanglingGates;
+    merged.containsState = merged.containsState || blocks[right].containsState;
+    blocks[right].support.clear();
+    ++version[left];
+    ++version[right];
+
+    next[left] = next[right];
+    if (next[left] < nblocks) {
+      prev[next[left]] = left;
+      pushCandidate(left);
+    }
+    if (left > 0) {
+      pushCandidate(prev[left]);
+    }
+  }
+  setSimulationPath(components, true);
+}
+
 template <class Config> void PathSimulator<Config>::constructTaskGraph() {
   const auto& path = simulationPath.components;
   const auto& steps = simulationPath.steps;
@@ -427,31 +639,11 @@ template <class Config> void PathSimulator<Config>::constructTaskGraph() {
     const auto [leftID, rightID] = path.at(i);
     const auto& resultStep = steps.at(nleaves + i);
 
-    // basic construction steps of matrices and initial state
-    if (leftID < nleaves) {
-      if (leftID == 0) {
-        // initial state
-        qc::VectorDD zeroState = Simulator<Config>::dd->makeZeroState(
-            static_cast<dd::Qubit>(CircuitSimulator<Config>::qc->getNqubits()));
-        Simulator<Config>::dd->incRef(zeroState);
-        results.emplace(leftID, zeroState);
-      } else {
-        const auto& op = CircuitSimulator<Config>::qc->at(leftID - 1);
-        qc::MatrixDD opDD = dd::getDD(op.get(), *Simulator<Config>::dd);
-        Simulator<Config>::dd->incRef(opDD);
-        results.emplace(leftID, opDD);
-      }
-    }
-
-    if (rightID < nleaves) {
-      if (rightID == 0) {
-        throw std::runtime_error("Initial state must not appear on right side "
-                                 "of the simulation path member.");
-      }
-      const auto& op = CircuitSimulator<Config>::qc->at(rightID - 1);
-      qc::MatrixDD opDD = dd::getDD(op.get(), *Simulator<Config>::dd);
-      Simulator<Config>::dd->incRef(opDD);
-      results.emplace(rightID, opDD);
+    // the matrices and the initial state are only constructed by the task
+    // consuming them
+    if (rightID == 0) {
+      throw std::runtime_error("Initial state must not appear on right side "
+                               "of the simulation path member.");
     }
 
     // add MxV / MxM task
@@ -491,42 +683,433 @@ void PathSimulator<Config>::addSimulationTask(std::size_t leftID,
                                               std::size_t rightID,
                                               std::size_t resultID) {
   const auto runner = [this, leftID, rightID, resultID]() {
-    /// Enable the following statement for printing execution order
-    //            std::cout << "Executing " << leftID << " " << rightID << " ->
-    //            " << resultID << std::endl;
-    const auto& leftDD = results.at(leftID);
-    const auto& rightDD = results.at(rightID);
+    contract(leftID, rightID, resultID);
+  };
+
+  const auto resultTask =
+      taskflow.emplace(runner).name(std::to_string(resultID));
+  tasks.emplace(resultID, resultTask);
+}
+
+template <class Config>
+void PathSimulator<Config>::materializeLeaf(const std::size_t id) {
+  if (id == 0) {
+    // initial state
+    qc::VectorDD zeroState = Simulator<Config>::dd->makeZeroState(
+        static_cast<dd::Qubit>(CircuitSimulator<Config>::qc->getNqubits()));
+    Simulator<Config>::dd->incRef(zeroState);
+    results.emplace(id, zeroState);
+    trackResult(id, zeroState);
+  } else {
+    const auto& op = CircuitSimulator<Config>::qc->at(id - 1);
+    qc::MatrixDD opDD = getGateDD(*op);
+    Simulator<Config>::dd->incRef(opDD);
+    results.emplace(id, opDD);
+    trackResult(id, opDD);
+  }
+}
+
+template <class Config>
+qc::MatrixDD PathSimulator<Config>::getGateDD(const qc::Operation& op) {
+  if (gateCacheCapacity == 0 || !op.isStandardOperation()) {
+    return dd::getDD(&op, *Simulator<Config>::dd);
+  }
+
+  // identical gates (including their parameters) share their DD
+  GateKey key{};
+  key.reserve(3 + op.getNtargets() + (2 * op.getNcontrols()) +
+              op.getParameter().size());
+  key.emplace_back(static_cast<std::uint64_t>(op.getType()));
+  key.emplace_back(op.getNtargets());
+  for (const auto& target : op.getTargets()) {
+    key.emplace_back(target);
+  }
+  key.emplace_back(op.getNcontrols());
+  for (const auto& control : op.getControls()) {
+    key.emplace_back(control.qubit);
+    key.emplace_back(static_cast<std::uint64_t>(control.type));
+  }
+  for (const auto& parameter : op.getParameter()) {
+    std::uint64_t bits{};
+    std::memcpy(&bits, &parameter, sizeof(bits));
+    key.emplace_back(bits);
+  }
+
+  if (const auto it = gateCache.find(key); it != gateCache.end()) {
+    ++gateCacheHits;
+    return it->second;
+  }
+  ++gateCacheMisses;
+  auto opDD = dd::getDD(&op, *Simulator<Config>::dd);
+  if (gateCache.size() < gateCacheCapacity) {
+    // the cache holds its own reference until the end of the run
+    Simulator<Config>::dd->incRef(opDD);
+    gateCache.emplace(std::move(key), opDD);
+  }
+  return opDD;
+}
+
+template <class Config> void PathSimulator<Config>::clearGateCache() {
+  for (const auto& [key, opDD] : gateCache) {
+    Simulator<Config>::dd->decRef(opDD);
+  }
+  gateCache.clear();
+}
+
+template <class Config>
+void PathSimulator<Config>::contract(const std::size_t leftID,
+                                     const std::size_t rightID,
+                                     const std::size_t resultID) {
+  /// Enable the following statement for printing execution order
+  //            std::cout << "Executing " << leftID << " " << rightID << " ->
+  //            " << resultID << std::endl;
+  const std::size_t nleaves = CircuitSimulator<Config>::qc->getNops() + 1;
+  if (leftID < nleaves) {
+    materializeLeaf(leftID);
+  }
+  if (rightID < nleaves) {
+    materializeLeaf(rightID);
+  }
+
+  const auto& leftDD = results.at(leftID);
+  const auto& rightDD = results.at(rightID);
+
+  const auto leftIsVector = std::holds_alternative<qc::VectorDD>(leftDD);
+  const auto rightIsVector = std::holds_alternative<qc::VectorDD>(rightDD);
+
+  if (rightIsVector) {
+    throw std::runtime_error("Right element in this simulation path member "
+                             "is a vector. This should not happen!");
+  }
+
+  if (leftIsVector) {
+    // matrix-vector multiplication
+    const auto& vector = *std::get_if<qc::VectorDD>(&leftDD);
+    const auto& matrix = *std::get_if<qc::MatrixDD>(&rightDD);
+    auto resultDD = Simulator<Config>::dd->multiply(matrix, vector);
+    Simulator<Config>::dd->incRef(resultDD);
+    Simulator<Config>::dd->decRef(vector);
+    Simulator<Config>::dd->decRef(matrix);
+    results.emplace(resultID, resultDD);
+    trackResult(resultID, resultDD);
+  } else {
+    // matrix-matrix multiplication
+    const auto& leftMatrix = *std::get_if<qc::MatrixDD>(&leftDD);
+    const auto& rightMatrix = *std::get_if<qc::MatrixDD>(&rightDD);
+    auto resultDD = Simulator<Config>::dd->multiply(rightMatrix, leftMatrix);
+    Simulator<Config>::dd->incRef(resultDD);
+    Simulator<Config>::dd->decRef(leftMatrix);
+    Simulator<Config>::dd->decRef(rightMatrix);
+    results.emplace(resultID, resultDD);
+    trackResult(resultID, resultDD);
+  }
+  Simulator<Config>::collectGarbage();
+  results.erase(leftID);
+  results.erase(rightID);
+  releaseResult(leftID);
+  releaseResult(rightID);
+}
+
+template <class Config>
+template <class Node>
+void PathSimulator<Config>::trackResult(const std::size_t id,
+                                        const dd::Edge<Node>& result) {
+  // determining the size traverses the whole DD
+  if (!memoryAwareScheduling) {
+    return;
+  }
+  const auto nodes = result.size();
+  resultSizes[id] = nodes;
+  liveNodes += nodes;
+  peakLiveNodes = std::max(peakLiveNodes, liveNodes);
+}
+
+template <class Config>
+void PathSimulator<Config>::releaseResult(const std::size_t id) {
+  const auto it = resultSizes.find(id);
+  if (it != resultSizes.end()) {
+    liveNodes -= it->second;
+    resultSizes.erase(it);
+  }
+}
+
+template <class Config> void PathSimulator<Config>::runMemoryAwareSchedule() {
+  const auto& path = simulationPath.components;
+  const auto& steps = simulationPath.steps;
+  const std::size_t nleaves = CircuitSimulator<Config>::qc->getNops() + 1;
+
+  if (path.empty()) {
+    Simulator<Config>::rootEdge = Simulator<Config>::dd->makeZeroState(
+        static_cast<dd::Qubit>(CircuitSimulator<Config>::qc->getNqubits()));
+    return;
+  }
 
-    const auto leftIsVector = std::holds_alternative<qc::VectorDD>(leftDD);
-    const auto rightIsVector = std::holds_alternative<qc::VectorDD>(rightDD);
+  // ready tasks ordered by the number of nodes their execution frees. Leaves
+  // are only constructed once their task runs and never count as freed.
+  // Ties are broken in favor of the order given by the path.
+  using Entry = std::pair<std::size_t, std::size_t>;
+  const auto compare = [](const Entry& lhs, const Entry& rhs) {
+    if (lhs.first != rhs.first) {
+      return lhs.first < rhs.first;
+    }
+    return lhs.second > rhs.second;
+  };
+  std::priority_queue<Entry, std::vector<Entry>, decltype(compare)> ready(
+      compare);
 
-    if (rightIsVector) {
+  const auto available = [this, nleaves](const std::size_t id) {
+    return id < nleaves || results.count(id) > 0;
+  };
+  const auto freedNodes = [this, nleaves](const std::size_t id) {
+    return id < nleaves ? 0 : resultSizes.at(id);
+  };
+  const auto enqueueIfReady = [&](const std::size_t i) {
+    const auto [leftID, rightID] = path.at(i);
+    if (available(leftID) && available(rightID)) {
+      ready.emplace(freedNodes(leftID) + freedNodes(rightID), i);
+    }
+  };
+
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    const auto [leftID, rightID] = path.at(i);
+    if (rightID == 0) {
+      throw std::runtime_error("Initial state must not appear on right side "
+                               "of the simulation path member.");
+    }
+    if (leftID < nleaves && rightID < nleaves) {
+      enqueueIfReady(i);
+    }
+  }
+
+  while (!ready.empty()) {
+    const auto i = ready.top().second;
+    ready.pop();
+    const auto [leftID, rightID] = path.at(i);
+    const auto resultID = nleaves + i;
+    contract(leftID, rightID, resultID);
+
+    const auto parent = steps.at(resultID).parent;
+    if (parent != SimulationPath::Step::UNKNOWN) {
+      enqueueIfReady(parent - nleaves);
+    }
+  }
+
+  const auto resultID = steps.size() - 1;
+  if (const auto* res = std::get_if<qc::VectorDD>(&results.at(resultID))) {
+    Simulator<Config>::rootEdge = *res;
+  } else {
+    throw std::runtime_error("Expected vector DD as result.");
+  }
+}
+
+template <class Config> void PathSimulator<Config>::simulateAdaptive() {
+  const auto& qc = CircuitSimulator<Config>::qc;
+  auto& dd = Simulator<Config>::dd;
+  const std::size_t nleaves = qc->getNops() + 1;
+
+  typename SimulationPath::Components components{};
+  components.reserve(qc->getNops());
+
+  auto state = dd->makeZeroState(static_cast<dd::Qubit>(qc->getNqubits()));
+  dd->incRef(state);
+  std::size_t stateID = 0;
+  // determining the size traverses the whole state, so it is only done once a
+  // merge passes the growth limit and is cached until the state changes
+  std::optional<std::size_t> stateSize;
+  const auto currentStateSize = [&state, &stateSize]() {
+    if (!stateSize) {
+      stateSize = state.size();
+    }
+    return *stateSize;
+  };
+
+  // operations that have been merged but not yet applied to the state
+  qc::MatrixDD block{};
+  std::size_t blockID = 0;
+  std::size_t blockSize = 0;
+  bool hasBlock = false;
+
+  const auto applyBlock = [&]() {
+    auto result = dd->multiply(block, state);
+    dd->incRef(result);
+    dd->decRef(state);
+    dd->decRef(block);
+    state = result;
+    Simulator<Config>::collectGarbage();
+
+    components.emplace_back(stateID, blockID);
+    stateID = nleaves + components.size() - 1;
+    stateSize.reset();
+    hasBlock = false;
+    ++adaptiveMxV;
+  };
+
+  for (std::size_t id = 1; id < nleaves; ++id) {
+    auto opDD = dd::getDD(qc->at(id - 1).get(), *dd);
+    dd->incRef(opDD);
+
+    if (!hasBlock) {
+      block = opDD;
+      blockID = id;
+      blockSize = block.size();
+      hasBlock = true;
+      continue;
+    }
+
+    // try merging the operation into the pending block and keep the product
+    // only if it did not grow too much
+    const auto opSize = opDD.size();
+    auto product = dd->multiply(opDD, block);
+    const auto productSize = product.size();
+    const auto limit =
+        adaptiveGrowthLimit * static_cast<double>(blockSize + opSize);
+    if (static_cast<double>(productSize) <= limit &&
+        productSize <= currentStateSize()) {
+      dd->incRef(product);
+      dd->decRef(block);
+      dd->decRef(opDD);
+      block = product;
+      Simulator<Config>::collectGarbage();
+
+      components.emplace_back(blockID, id);
+      blockID = nleaves + components.size() - 1;
+      blockSize = productSize;
+      ++adaptiveMxM;
+      continue;
+    }
+
+    ++adaptiveRejected;
+    applyBlock();
+    block = opDD;
+    blockID = id;
+    blockSize = opSize;
+    hasBlock = true;
+  }
+  if (hasBlock) {
+    applyBlock();
+  }
+
+  Simulator<Config>::rootEdge = state;
+  simulationPath =
+      SimulationPath(nleaves, std::move(components), qc.get(), true);
+  storeInPathCache();
+}
+
+template <class Config> void PathSimulator<Config>::simulateParallel() {
+  const auto& path = simulationPath.components;
+  const auto nqubits = CircuitSimulator<Config>::qc->getNqubits();
+
+  if (path.empty()) {
+    Simulator<Config>::rootEdge =
+        Simulator<Config>::dd->makeZeroState(static_cast<dd::Qubit>(nqubits));
+    return;
+  }
+
+  tf::Executor parallelExecutor(nthreads);
+  const auto nworkers = parallelExecutor.num_workers();
+  packages.clear();
+  packageGcPolicies.clear();
+  packages.reserve(nworkers);
+  packageGcPolicies.reserve(nworkers);
+  for (std::size_t i = 0; i < nworkers; ++i) {
+    packages.emplace_back(std::make_unique<dd::Package<Config>>(nqubits));
+    packageGcPolicies.emplace_back(Simulator<Config>::gcPolicy.clone());
+  }
+  pendingReleases.assign(nworkers, {});
+
+  constructParallelTaskGraph(parallelExecutor);
+  parallelExecutor.run(taskflow).wait();
+
+  // move the final state into the simulator's own package
+  const auto resultID = simulationPath.steps.size() - 1;
+  auto& result = results.at(resultID);
+  auto* state = std::get_if<qc::VectorDD>(&result);
+  if (state == nullptr) {
+    throw std::runtime_error("Expected vector DD as result.");
+  }
+  Simulator<Config>::rootEdge = Simulator<Config>::dd->transfer(*state);
+  Simulator<Config>::dd->incRef(Simulator<Config>::rootEdge);
+
+  results.clear();
+  owners.clear();
+  pendingReleases.clear();
+  for (const auto& policy : packageGcPolicies) {
+    Simulator<Config>::gcPolicy.mergeStatistics(policy);
+  }
+  packageGcPolicies.clear();
+  packages.clear();
+}
+
+template <class Config>
+void PathSimulator<Config>::constructParallelTaskGraph(
+    tf::Executor& parallelExecutor) {
+  const auto& path = simulationPath.components;
+  const auto& steps = simulationPath.steps;
+  const std::size_t nleaves = CircuitSimulator<Config>::qc->getNops() + 1;
+
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    const auto [leftID, rightID] = path.at(i);
+    const auto& resultStep = steps.at(nleaves + i);
+
+    if (rightID == 0) {
+      throw std::runtime_error("Initial state must not appear on right side "
+                               "of the simulation path member.");
+    }
+
+    // leaves are only constructed once the task runs, directly in the package
+    // of the worker executing it
+    addParallelSimulationTask(parallelExecutor, leftID, rightID,
+                              resultStep.id);
+
+    if (leftID >= nleaves) {
+      tasks.at(leftID).precede(tasks.at(resultStep.id));
+    }
+    if (rightID >= nleaves) {
+      tasks.at(rightID).precede(tasks.at(resultStep.id));
+    }
+  }
+}
+
+template <class Config>
+void PathSimulator<Config>::addParallelSimulationTask(
+    tf::Executor& parallelExecutor, std::size_t leftID, std::size_t rightID,
+    std::size_t resultID) {
+  const auto runner = [this, &parallelExecutor, leftID, rightID, resultID]() {
+    const auto worker =
+        static_cast<std::size_t>(parallelExecutor.this_worker_id());
+    auto& package = *packages.at(worker);
+    releasePending(worker);
+
+    const auto leftDD = fetchOperand(leftID, worker);
+    const auto rightDD = fetchOperand(rightID, worker);
+
+    if (std::holds_alternative<qc::VectorDD>(rightDD)) {
       throw std::runtime_error("Right element in this simulation path member "
                                "is a vector. This should not happen!");
     }
 
-    if (leftIsVector) {
+    std::variant<qc::VectorDD, qc::MatrixDD> resultDD;
+    const auto& rightMatrix = *std::get_if<qc::MatrixDD>(&rightDD);
+    if (const auto* vector = std::get_if<qc::VectorDD>(&leftDD)) {
       // matrix-vector multiplication
-      const auto& vector = *std::get_if<qc::VectorDD>(&leftDD);
-      const auto& matrix = *std::get_if<qc::MatrixDD>(&rightDD);
-      auto resultDD = Simulator<Config>::dd->multiply(matrix, vector);
-      Simulator<Config>::dd->incRef(resultDD);
-      Simulator<Config>::dd->decRef(vector);
-      Simulator<Config>::dd->decRef(matrix);
-      results.emplace(resultID, resultDD);
+      auto product = package.multiply(rightMatrix, *vector);
+      package.incRef(product);
+      package.decRef(*vector);
+      resultDD = product;
     } else {
       // matrix-matrix multiplication
       const auto& leftMatrix = *std::get_if<qc::MatrixDD>(&leftDD);
-      const auto& rightMatrix = *std::get_if<qc::MatrixDD>(&rightDD);
-      auto resultDD = Simulator<Config>::dd->multiply(rightMatrix, leftMatrix);
-      Simulator<Config>::dd->incRef(resultDD);
-      Simulator<Config>::dd->decRef(leftMatrix);
-      Simulator<Config>::dd->decRef(rightMatrix);
-      results.emplace(resultID, resultDD);
-    }
-    Simulator<Config>::dd->garbageCollect();
-    results.erase(leftID);
-    results.erase(rightID);
+      auto product = package.multiply(rightMatrix, leftMatrix);
+      package.incRef(product);
+      package.decRef(leftMatrix);
+      resultDD = product;
+    }
+    package.decRef(rightMatrix);
+    packageGcPolicies.at(worker).maybeCollect(package);
+
+    const std::lock_guard<std::mutex> lock(resultsMutex);
+    results.emplace(resultID, resultDD);
+    owners.emplace(resultID, worker);
   };
 
   const auto resultTask =
@@ -534,4 +1117,66 @@ void PathSimulator<Config>::addSimulationTask(std::size_t leftID,
   tasks.emplace(resultID, resultTask);
 }
 
+template <class Config>
+std::variant<qc::VectorDD, qc::MatrixDD>
+PathSimulator<Config>::fetchOperand(const std::size_t id,
+                                    const std::size_t worker) {
+  auto& package = *packages.at(worker);
+  const std::size_t nleaves = CircuitSimulator<Config>::qc->getNops() + 1;
+
+  if (id < nleaves) {
+    if (id == 0) {
+      // initial state
+      auto zeroState = package.makeZeroState(
+          static_cast<dd::Qubit>(CircuitSimulator<Config>::qc->getNqubits()));
+      package.incRef(zeroState);
+      return zeroState;
+    }
+    const auto& op = CircuitSimulator<Config>::qc->at(id - 1);
+    auto opDD = dd::getDD(op.get(), package);
+    package.incRef(opDD);
+    return opDD;
+  }
+
+  std::variant<qc::VectorDD, qc::MatrixDD> operand;
+  std::size_t owner{};
+  {
+    const std::lock_guard<std::mutex> lock(resultsMutex);
+    operand = results.at(id);
+    owner = owners.at(id);
+    results.erase(id);
+    owners.erase(id);
+  }
+  if (owner == worker) {
+    return operand;
+  }
+
+  // the operand lives in another package. The nodes stay referenced until the
+  // owning worker releases them, so it is safe to read them from here.
+  auto transferred = std::visit(
+      [&package](auto& edge) -> std::variant<qc::VectorDD, qc::MatrixDD> {
+        auto copy = package.transfer(edge);
+        package.incRef(copy);
+        return copy;
+      },
+      operand);
+
+  const std::lock_guard<std::mutex> lock(resultsMutex);
+  pendingReleases.at(owner).emplace_back(operand);
+  return transferred;
+}
+
+template <class Config>
+void PathSimulator<Config>::releasePending(const std::size_t worker) {
+  std::vector<std::variant<qc::VectorDD, qc::MatrixDD>> released;
+  {
+    const std::lock_guard<std::mutex> lock(resultsMutex);
+    std::swap(released, pendingReleases.at(worker));
+  }
+  auto& package = *packages.at(worker);
+  for (const auto& edge : released) {
+    std::visit([&package](const auto& e) { package.decRef(e); }, edge);
+  }
+}
+
 template class PathSimulator<dd::DDPackageConfig>;
@@ -109,7 +109,7 @@ ShorFastSimulator<Config>::simulate([[maybe_unused]] std::size_t shots) {
 
     measurements[i] = Simulator<Config>::measureOneCollapsing(
         static_cast<dd::Qubit>(nQubits - 1), false);
-    Simulator<Config>::dd->garbageCollect();
+    Simulator<Config>::collectGarbage();
 
     if (measurements[i] == '1') {
       applyGate(dd::X_MAT, static_cast<dd::Qubit>(nQubits - 1));
@@ -355,7 +355,7 @@ void ShorFastSimulator<Config>::applyGate(dd::GateMatrix matrix,
   Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
   Simulator<Config>::rootEdge = tmp;
 
-  Simulator<Config>::dd->garbageCollect();
+  Simulator<Config>::collectGarbage();
 }
 
 /**
@@ -460,7 +460,7 @@ void ShorFastSimulator<Config>::uAEmulate2(const std::uint64_t a) {
   Simulator<Config>::dd->incRef(res);
   Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
   Simulator<Config>::rootEdge = res;
-  Simulator<Config>::dd->garbageCollect();
+  Simulator<Config>::collectGarbage();
 }
 
 template <class Config>
@@ -443,7 +443,7 @@ void ShorSimulator<Config>::uAEmulate(std::uint64_t a, std::int32_t q) {
     Simulator<Config>::dd->decRef(f);
     f = Simulator<Config>::dd->add(active, passive);
     Simulator<Config>::dd->incRef(f);
-    Simulator<Config>::dd->garbageCollect();
+    Simulator<Config>::collectGarbage();
 
     t = (2 * t) % compositeN;
   }
@@ -476,7 +476,7 @@ void ShorSimulator<Config>::uAEmulate(std::uint64_t a, std::int32_t q) {
   Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
   Simulator<Config>::rootEdge = tmp;
 
-  Simulator<Config>::dd->garbageCollect();
+  Simulator<Config>::collectGarbage();
 }
 
 template <class Config>
@@ -501,7 +501,7 @@ void ShorSimulator<Config>::applyGate(dd::GateMatrix matrix, dd::Qubit target,
   Simulator<Config>::dd->decRef(Simulator<Config>::rootEdge);
   Simulator<Config>::rootEdge = tmp;
 
-  Simulator<Config>::dd->garbageCollect();
+  Simulator<Config>::collectGarbage();
 }
 
 template class ShorSimulator<dd::DDPackageConfig>;
@@ -0,0 +1,164 @@
+#include "SimulationPathCache.hpp"
+
+#include "ir/QuantumComputation.hpp"
+#include "ir/operations/CompoundOperation.hpp"
+#include "ir/operations/Operation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace {
+void combine(std::size_t& seed, const std::size_t value) {
+  // boost::hash_combine
+  seed ^= std::hash<std::size_t>{}(value) + 0x9e3779b97f4a7c15ULL +
+          (seed << 6U) + (seed >> 2U);
+}
+
+void hashOperation(std::size_t& seed, const qc::Operation& op) {
+  combine(seed, static_cast<std::size_t>(op.getType()));
+  combine(seed, op.getNtargets());
+  for (const auto& target : op.getTargets()) {
+    combine(seed, target);
+  }
+  combine(seed, op.getNcontrols());
+  for (const auto& control : op.getControls()) {
+    combine(seed, control.qubit);
+    combine(seed, static_cast<std::size_t>(control.type));
+  }
+  if (const auto* compound = dynamic_cast<const qc::CompoundOperation*>(&op)) {
+    for (const auto& inner : *compound) {
+      hashOperation(seed, *inner);
+    }
+  }
+}
+
+template <class T> void write(std::ostream& os, const T value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T> bool read(std::istream& is, T& value) {
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return static_cast<bool>(is);
+}
+} // namespace
+
+SimulationPathCache::SimulationPathCache(std::string directory_)
+    : directory(std::move(directory_)) {
+  std::filesystem::create_directories(directory);
+}
+
+std::size_t
+SimulationPathCache::structuralHash(const qc::QuantumComputation& qc) {
+  std::size_t seed = 0;
+  combine(seed, qc.getNqubits());
+  combine(seed, qc.getNops());
+  for (const auto& op : qc) {
+    hashOperation(seed, *op);
+  }
+  return seed;
+}
+
+std::size_t SimulationPathCache::key(const qc::QuantumComputation& qc,
+                                     const std::string& strategy) {
+  auto seed = structuralHash(qc);
+  combine(seed, std::hash<std::string>{}(strategy));
+  return seed;
+}
+
+std::string SimulationPathCache::filename(const std::size_t key) const {
+  std::ostringstream ss;
+  ss << std::hex << key << ".path";
+  return (std::filesystem::path(directory) / ss.str()).string();
+}
+
+std::optional<SimulationPathCache::Components>
+SimulationPathCache::lookup(const std::size_t key,
+                            const std::size_t nleaves) const {
+  std::ifstream ifs(filename(key), std::ios::binary);
+  if (!ifs.good()) {
+    return std::nullopt;
+  }
+
+  std::uint32_t magic{};
+  std::uint32_t version{};
+  std::uint64_t storedKey{};
+  std::uint64_t storedLeaves{};
+  std::uint64_t ncomponents{};
+  if (!read(ifs, magic) || magic != MAGIC || !read(ifs, version) ||
+      version != VERSION || !read(ifs, storedKey) || storedKey != key ||
+      !read(ifs, storedLeaves) || storedLeaves != nleaves ||
+      !read(ifs, ncomponents)) {
+    return std::nullopt;
+  }
+  // a complete path contracts all leaves into a single result
+  if (ncomponents + 1 != nleaves) {
+    return std::nullopt;
+  }
+
+  Components components{};
+  components.reserve(ncomponents);
+  for (std::uint64_t i = 0; i < ncomponents; ++i) {
+    std::uint64_t left{};
+    std::uint64_t right{};
+    if (!read(ifs, left) || !read(ifs, right)) {
+      return std::nullopt;
+    }
+    components.emplace_back(left, right);
+  }
+  return components;
+}
+
+void SimulationPathCache::store(const std::size_t key,
+                                const std::size_t nleaves,
+                                const Components& components) const {
+  // write to a temporary file first so that concurrent readers never see a
+  // partially written entry. The name is unique per writer, so concurrent
+  // jobs storing the same key never write into the same file.
+  const auto target = filename(key);
+  std::random_device rd;
+  const auto temporary =
+      target + "." + std::to_string(rd()) + "_" + std::to_string(rd()) + ".tmp";
+  {
+    std::ofstream ofs(temporary, std::ios::binary | std::ios::trunc);
+    if (!ofs.good()) {
+      throw std::runtime_error("Cannot write simulation path cache entry " +
+                               temporary);
+    }
+    write(ofs, MAGIC);
+    write(ofs, VERSION);
+    write(ofs, static_cast<std::uint64_t>(key));
+    write(ofs, static_cast<std::uint64_t>(nleaves));
+    write(ofs, static_cast<std::uint64_t>(components.size()));
+    for (const auto& [left, right] : components) {
+      write(ofs, static_cast<std::uint64_t>(left));
+      write(ofs, static_cast<std::uint64_t>(right));
+    }
+    if (!ofs.good()) {
+      ofs.close();
+      std::error_code ec;
+      std::filesystem::remove(temporary, ec);
+      throw std::runtime_error("Cannot write simulation path cache entry " +
+                               temporary);
+    }
+  }
+  // replaces an entry stored concurrently by another job for the same key
+  std::error_code ec;
+  std::filesystem::rename(temporary, target, ec);
+  if (ec) {
+    std::error_code ignored;
+    std::filesystem::remove(temporary, ignored);
+    throw std::runtime_error("Cannot store simulation path cache entry " +
+                             target + ": " + ec.message());
+  }
+}
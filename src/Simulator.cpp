@@ -1,5 +1,7 @@
 #include "Simulator.hpp"
 
+#include "AliasSampler.hpp"
+#include "PackedBitString.hpp"
 #include "dd/ComplexNumbers.hpp"
 #include "dd/ComplexValue.hpp"
 #include "dd/DDDefinitions.hpp"
@@ -34,34 +36,21 @@ template <class Config>
 std::map<std::string, std::size_t>
 Simulator<Config>::sampleFromAmplitudeVectorInPlace(
     std::vector<std::complex<dd::fp>>& amplitudes, size_t shots) {
-  // in-place prefix-sum calculation of probabilities
-  std::inclusive_scan(
-      amplitudes.begin(), amplitudes.end(), amplitudes.begin(),
-      [](const std::complex<dd::fp>& prefix,
-         const std::complex<dd::fp>& value) {
-        return std::complex<dd::fp>{
-            std::fma(value.real(), value.real(),
-                     std::fma(value.imag(), value.imag(), prefix.real())),
-            value.imag()};
-      },
-      std::complex<dd::fp>{0., 0.});
-
-  std::map<std::string, std::size_t> results;
-  std::uniform_real_distribution<dd::fp> dist(0.0L, 1.0L);
-  for (unsigned int i = 0; i < shots; ++i) {
-    auto p = dist(mt);
-    // use binary search to find the first entry >= p
-    auto mit =
-        std::upper_bound(amplitudes.begin(), amplitudes.end(), p,
-                         [](const dd::fp val, const std::complex<dd::fp>& c) {
-                           return val < c.real();
-                         });
-    auto m = std::distance(amplitudes.begin(), mit);
-
-    // construct basis state string
-    auto basisState =
-        dd::intToBinaryString(static_cast<std::size_t>(m), getNumberOfQubits());
-    results[basisState]++;
+  return toStringHistogram(
+      sampleFromAmplitudeVectorInPlaceCompact(amplitudes, shots),
+      getNumberOfQubits());
+}
+
+template <class Config>
+PackedHistogram
+Simulator<Config>::sampleFromAmplitudeVectorInPlaceCompact(
+    std::vector<std::complex<dd::fp>>& amplitudes, const std::size_t shots) {
+  // the alias table is built in the memory of the amplitude vector
+  const AliasSampler sampler(std::move(amplitudes));
+  const auto nqubits = getNumberOfQubits();
+  PackedHistogram results;
+  for (const auto& [index, count] : sampler.sample(shots, mt)) {
+    results.emplace(fromIndex(index, nqubits), count);
   }
   return results;
 }
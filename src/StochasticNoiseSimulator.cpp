@@ -1,6 +1,8 @@
 #include "StochasticNoiseSimulator.hpp"
 
 #include "Definitions.hpp"
+#include "GarbageCollectionPolicy.hpp"
+#include "PackedBitString.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
 #include "dd/Node.hpp"
@@ -25,20 +27,30 @@
 
 std::map<std::string, std::size_t>
 StochasticNoiseSimulator::simulate(const size_t nshots) {
+  return toStringHistogram(simulateCompact(nshots), qc->getNcbits());
+}
+
+PackedHistogram StochasticNoiseSimulator::simulateCompact(const size_t nshots) {
   stochasticRuns = nshots;
   classicalMeasurementsMaps.resize(maxInstances);
+  std::vector<GarbageCollectionPolicy> gcPolicies(maxInstances,
+                                                  gcPolicy.clone());
   std::vector<std::thread> threadArray;
   // The stochastic runs are applied in parallel
   const auto t1Stoch = std::chrono::steady_clock::now();
   for (std::size_t runID = 0U; runID < maxInstances; runID++) {
     threadArray.emplace_back(&StochasticNoiseSimulator::runStochSimulationForId,
                              this, runID, getNumberOfQubits(),
-                             std::ref(classicalMeasurementsMaps[runID]), mt());
+                             std::ref(classicalMeasurementsMaps[runID]),
+                             std::ref(gcPolicies[runID]), mt());
   }
   // wait for threads to finish
   for (auto& thread : threadArray) {
     thread.join();
   }
+  for (const auto& localPolicy : gcPolicies) {
+    gcPolicy.mergeStatistics(localPolicy);
+  }
   const auto t2Stoch = std::chrono::steady_clock::now();
   stochRunTime = std::chrono::duration<double>(t2Stoch - t1Stoch).count();
 
@@ -53,8 +65,8 @@ StochasticNoiseSimulator::simulate(const size_t nshots) {
 
 void StochasticNoiseSimulator::runStochSimulationForId(
     std::size_t stochRun, qc::Qubit nQubits,
-    std::map<std::string, size_t>& classicalMeasurementsMap,
-    std::uint64_t localSeed) {
+    PackedHistogram& classicalMeasurementsMap,
+    GarbageCollectionPolicy& localGcPolicy, std::uint64_t localSeed) {
   std::mt19937_64 generator(localSeed);
 
   const std::uint64_t numberOfRuns =
@@ -116,7 +128,7 @@ void StochasticNoiseSimulator::runStochSimulationForId(
               localDD->incRef(tmp);
               localDD->decRef(localRootEdge);
               localRootEdge = tmp;
-              localDD->garbageCollect();
+              localGcPolicy.maybeCollect(*localDD);
             }
           }
         } else {
@@ -175,28 +187,31 @@ void StochasticNoiseSimulator::runStochSimulationForId(
                               approximationInfo.stepFidelity, false, true);
         ++approximationRuns;
       }
-      localDD->garbageCollect();
+      localGcPolicy.maybeCollect(*localDD);
     }
     localDD->decRef(localRootEdge);
 
     if (!classicValues.empty()) {
-      const auto cbits = qc->getNcbits();
-      std::string classicRegisterString(cbits, '0');
+      PackedBitString classicRegister(packedWords(qc->getNcbits()), 0U);
 
       for (const auto& [bitIndex, value] : classicValues) {
-        classicRegisterString[cbits - bitIndex - 1] = value ? '1' : '0';
+        if (value) {
+          classicRegister[bitIndex / 64U] |= 1ULL << (bitIndex % 64U);
+        }
       }
-      classicalMeasurementsMap[classicRegisterString] += 1U;
+      classicalMeasurementsMap[classicRegister] += 1U;
     }
   }
 }
 
 std::map<std::string, std::string>
 StochasticNoiseSimulator::additionalStatistics() {
-  return {
+  auto statistics = gcPolicy.statistics();
+  statistics.insert({
       {"approximation_runs", std::to_string(approximationRuns)},
       {"stoch_wall_time", std::to_string(stochRunTime)},
       {"stoch_runs", std::to_string(stochasticRuns)},
       {"threads", std::to_string(maxInstances)},
-  };
+  });
+  return statistics;
 }
@@ -0,0 +1,131 @@
+#include "VectorDDSampler.hpp"
+
+#include "PackedBitString.hpp"
+#include "dd/ComplexNumbers.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <taskflow/core/async.hpp>
+#include <taskflow/core/executor.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+VectorDDSampler::VectorDDSampler(const dd::vEdge& rootEdge,
+                                 const std::size_t nqubits_)
+    : nqubits(nqubits_) {
+  if (rootEdge.w.exactlyZero()) {
+    throw std::runtime_error(
+        "Numerical instabilities led to a 0-vector! Abort sampling!");
+  }
+  if (rootEdge.isTerminal()) {
+    return;
+  }
+
+  // maps every visited DD node to its index and the squared norm of the
+  // sub-vector it represents
+  std::unordered_map<const dd::vNode*, std::pair<std::size_t, dd::fp>> visited;
+
+  std::function<std::pair<std::size_t, dd::fp>(const dd::vEdge&)> flatten =
+      [&](const dd::vEdge& e) -> std::pair<std::size_t, dd::fp> {
+    if (e.w.exactlyZero()) {
+      return {TERMINAL, 0.};
+    }
+    const auto weight = dd::ComplexNumbers::mag2(e.w);
+    if (e.isTerminal()) {
+      return {TERMINAL, weight};
+    }
+    if (const auto it = visited.find(e.p); it != visited.end()) {
+      return {it->second.first, weight * it->second.second};
+    }
+
+    const auto idx = nodes.size();
+    nodes.emplace_back();
+    nodes[idx].v = e.p->v;
+    const auto [zeroChild, zeroNorm] = flatten(e.p->e[0]);
+    const auto [oneChild, oneNorm] = flatten(e.p->e[1]);
+    const auto norm = zeroNorm + oneNorm;
+    nodes[idx].children = {zeroChild, oneChild};
+    nodes[idx].zeroProbability = norm > 0. ? zeroNorm / norm : 0.;
+    visited.emplace(e.p, std::pair{idx, norm});
+    return {idx, weight * norm};
+  };
+  root = flatten(rootEdge).first;
+}
+
+PackedHistogram VectorDDSampler::sample(const std::size_t shots,
+                                        std::mt19937_64& mt) const {
+  PackedHistogram histogram;
+  sampleInto(histogram, shots, mt);
+  return histogram;
+}
+
+PackedHistogram VectorDDSampler::sample(const std::size_t shots,
+                                        std::mt19937_64& mt,
+                                        const std::size_t nthreads) const {
+  const auto nchunks = (shots + SHOTS_PER_CHUNK - 1) / SHOTS_PER_CHUNK;
+  std::vector<std::uint64_t> seeds(nchunks);
+  for (auto& chunkSeed : seeds) {
+    chunkSeed = mt();
+  }
+  const auto chunkShots = [&](const std::size_t chunk) {
+    return std::min(SHOTS_PER_CHUNK, shots - (chunk * SHOTS_PER_CHUNK));
+  };
+
+  if (nthreads <= 1 || nchunks <= 1) {
+    PackedHistogram histogram;
+    for (std::size_t chunk = 0; chunk < nchunks; ++chunk) {
+      std::mt19937_64 chunkMt(seeds[chunk]);
+      sampleInto(histogram, chunkShots(chunk), chunkMt);
+    }
+    return histogram;
+  }
+
+  tf::Executor executor(std::min(nthreads, nchunks));
+  std::vector<PackedHistogram> histograms(executor.num_workers());
+  for (std::size_t chunk = 0; chunk < nchunks; ++chunk) {
+    executor.silent_async([&, chunk]() {
+      std::mt19937_64 chunkMt(seeds[chunk]);
+      const auto worker = static_cast<std::size_t>(executor.this_worker_id());
+      sampleInto(histograms[worker], chunkShots(chunk), chunkMt);
+    });
+  }
+  executor.wait_for_all();
+
+  auto& histogram = histograms.front();
+  for (auto it = std::next(histograms.begin()); it != histograms.end(); ++it) {
+    for (const auto& [bits, count] : *it) {
+      histogram[bits] += count;
+    }
+  }
+  return std::move(histogram);
+}
+
+void VectorDDSampler::sampleInto(PackedHistogram& histogram,
+                                 const std::size_t shots,
+                                 std::mt19937_64& mt) const {
+  PackedBitString bits(packedWords(nqubits), 0U);
+  std::uniform_real_distribution<dd::fp> dist(0.0, 1.0);
+
+  for (std::size_t shot = 0; shot < shots; ++shot) {
+    std::fill(bits.begin(), bits.end(), 0U);
+    auto idx = root;
+    while (idx != TERMINAL) {
+      const auto& node = nodes[idx];
+      if (dist(mt) < node.zeroProbability) {
+        idx = node.children[0];
+      } else {
+        bits[node.v / 64U] |= 1ULL << (node.v % 64U);
+        idx = node.children[1];
+      }
+    }
+    ++histogram[bits];
+  }
+}
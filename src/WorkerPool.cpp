@@ -0,0 +1,319 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifndef _WIN32
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <exception>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+WorkerPool::WorkerPool(const std::size_t nworkers_)
+    : nworkers(std::max<std::size_t>(nworkers_, 1)) {}
+
+#ifdef _WIN32
+
+bool WorkerPool::isSupported() { return false; }
+
+void WorkerPool::run(const std::size_t /*nitems*/,
+                     const std::size_t /*rangeSize*/,
+                     const ProcessRange& /*process*/,
+                     const Finish& /*finish*/,
+                     const Collect& /*collect*/) const {
+  throw std::runtime_error(
+      "Worker processes are not supported on this platform.");
+}
+
+#else
+
+namespace {
+void writeAll(const int fd, const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    const auto written = ::write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EPIPE) {
+        throw std::runtime_error("A worker process terminated unexpectedly.");
+      }
+      throw std::runtime_error("Failed to write to a worker pipe.");
+    }
+    bytes += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+void readAll(const int fd, void* data, std::size_t size) {
+  auto* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    const auto nread = ::read(fd, bytes, size);
+    if (nread < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Failed to read from a worker pipe.");
+    }
+    if (nread == 0) {
+      throw std::runtime_error("A worker process terminated unexpectedly.");
+    }
+    bytes += nread;
+    size -= static_cast<std::size_t>(nread);
+  }
+}
+
+// blocks SIGPIPE for the calling thread, so that writing to the pipe of a
+// terminated process fails with EPIPE instead of killing the process
+class SigpipeBlocker {
+public:
+  SigpipeBlocker() {
+    sigemptyset(&sigpipe);
+    sigaddset(&sigpipe, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigpipe, &previous);
+    sigset_t pending;
+    sigemptyset(&pending);
+    alreadyPending =
+        sigpending(&pending) == 0 && sigismember(&pending, SIGPIPE) == 1;
+  }
+  ~SigpipeBlocker() {
+    if (sigismember(&previous, SIGPIPE) == 0) {
+      // discard a SIGPIPE raised while blocked instead of delivering it
+      sigset_t pending;
+      sigemptyset(&pending);
+      if (!alreadyPending && sigpending(&pending) == 0 &&
+          sigismember(&pending, SIGPIPE) == 1) {
+        int signal = 0;
+        sigwait(&sigpipe, &signal);
+      }
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+  }
+  SigpipeBlocker(const SigpipeBlocker&) = delete;
+  SigpipeBlocker& operator=(const SigpipeBlocker&) = delete;
+
+private:
+  sigset_t sigpipe{};
+  sigset_t previous{};
+  bool alreadyPending = false;
+};
+
+// a range of items sent to a worker, an empty range terminates the worker
+using Range = std::array<std::uint64_t, 2>;
+
+// the kind of a message sent from a worker to the coordinator
+enum class Message : char {
+  // a range has been processed
+  Done,
+  // followed by the size and the data of the worker's result
+  Result,
+  // followed by the size and the text of the error that stopped the worker
+  Error
+};
+
+struct Worker {
+  pid_t pid = -1;
+  // coordinator -> worker
+  int tasks = -1;
+  // worker -> coordinator
+  int results = -1;
+  bool done = false;
+};
+
+void writeMessage(const int fd, const Message kind, const std::string& data) {
+  writeAll(fd, &kind, sizeof(kind));
+  const auto size = static_cast<std::uint64_t>(data.size());
+  writeAll(fd, &size, sizeof(size));
+  writeAll(fd, data.data(), data.size());
+}
+
+std::string readData(const int fd) {
+  std::uint64_t size = 0;
+  readAll(fd, &size, sizeof(size));
+  std::string data(size, '\0');
+  readAll(fd, data.data(), data.size());
+  return data;
+}
+
+// reads the next message of a worker and rethrows the error it reported
+Message readMessage(const int fd) {
+  auto kind = Message::Done;
+  readAll(fd, &kind, sizeof(kind));
+  if (kind == Message::Error) {
+    throw std::runtime_error("A worker process failed: " + readData(fd));
+  }
+  return kind;
+}
+
+[[noreturn]] void runWorker(const int tasks, const int results,
+                            const WorkerPool::ProcessRange& process,
+                            const WorkerPool::Finish& finish) {
+  int status = 0;
+  try {
+    while (true) {
+      Range range{};
+      readAll(tasks, range.data(), sizeof(range));
+      if (range[1] == 0) {
+        break;
+      }
+      process(range[0], range[1]);
+      const auto done = Message::Done;
+      writeAll(results, &done, sizeof(done));
+    }
+    writeMessage(results, Message::Result, finish());
+  } catch (const std::exception& e) {
+    status = 1;
+    try {
+      writeMessage(results, Message::Error, e.what());
+    } catch (const std::exception&) {
+      // the coordinator is gone or already noticed the failure
+    }
+  }
+  // do not run any handlers inherited from the coordinator
+  ::_exit(status);
+}
+
+void closeAll(std::vector<Worker>& workers) {
+  for (auto& worker : workers) {
+    if (worker.tasks >= 0) {
+      ::close(worker.tasks);
+      worker.tasks = -1;
+    }
+    if (worker.results >= 0) {
+      ::close(worker.results);
+      worker.results = -1;
+    }
+  }
+}
+
+void killAll(std::vector<Worker>& workers) {
+  closeAll(workers);
+  for (auto& worker : workers) {
+    if (worker.pid > 0) {
+      ::kill(worker.pid, SIGKILL);
+      ::waitpid(worker.pid, nullptr, 0);
+      worker.pid = -1;
+    }
+  }
+}
+} // namespace
+
+bool WorkerPool::isSupported() { return true; }
+
+void WorkerPool::run(const std::size_t nitems, const std::size_t rangeSize,
+                     const ProcessRange& process, const Finish& finish,
+                     const Collect& collect) const {
+  const auto chunk = std::max<std::size_t>(rangeSize, 1);
+  // the workers inherit the blocked signal
+  const SigpipeBlocker sigpipeBlocker;
+  std::vector<Worker> workers(nworkers);
+  try {
+    for (auto& worker : workers) {
+      std::array<int, 2> tasks{};
+      std::array<int, 2> results{};
+      if (::pipe(tasks.data()) != 0) {
+        throw std::runtime_error("Failed to create a worker pipe.");
+      }
+      if (::pipe(results.data()) != 0) {
+        ::close(tasks[0]);
+        ::close(tasks[1]);
+        throw std::runtime_error("Failed to create a worker pipe.");
+      }
+      const auto pid = ::fork();
+      if (pid < 0) {
+        for (const auto fd : {tasks[0], tasks[1], results[0], results[1]}) {
+          ::close(fd);
+        }
+        throw std::runtime_error("Failed to start a worker process.");
+      }
+      if (pid == 0) {
+        // the worker only keeps its own ends of its own pipes
+        closeAll(workers);
+        ::close(tasks[1]);
+        ::close(results[0]);
+        runWorker(tasks[0], results[1], process, finish);
+      }
+      ::close(tasks[0]);
+      ::close(results[1]);
+      worker.pid = pid;
+      worker.tasks = tasks[1];
+      worker.results = results[0];
+    }
+
+    std::size_t next = 0;
+    const auto assign = [&next, nitems, chunk](Worker& worker) {
+      Range range{static_cast<std::uint64_t>(next), 0};
+      if (next < nitems) {
+        range[1] = std::min(chunk, nitems - next);
+        next += range[1];
+      } else {
+        worker.done = true;
+      }
+      writeAll(worker.tasks, range.data(), sizeof(range));
+    };
+    for (auto& worker : workers) {
+      assign(worker);
+    }
+
+    // hand out the remaining ranges to whichever worker finishes first
+    while (std::any_of(workers.begin(), workers.end(),
+                       [](const Worker& worker) { return !worker.done; })) {
+      std::vector<pollfd> fds;
+      std::vector<Worker*> busy;
+      for (auto& worker : workers) {
+        if (!worker.done) {
+          fds.push_back({worker.results, POLLIN, 0});
+          busy.emplace_back(&worker);
+        }
+      }
+      if (::poll(fds.data(), fds.size(), -1) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::runtime_error("Failed to wait for the worker processes.");
+      }
+      for (std::size_t i = 0; i < fds.size(); ++i) {
+        if (fds[i].revents == 0) {
+          continue;
+        }
+        if (readMessage(busy[i]->results) != Message::Done) {
+          throw std::runtime_error("Unexpected message from a worker.");
+        }
+        assign(*busy[i]);
+      }
+    }
+
+    for (auto& worker : workers) {
+      if (readMessage(worker.results) != Message::Result) {
+        throw std::runtime_error("Unexpected message from a worker.");
+      }
+      collect(readData(worker.results));
+
+      int status = 0;
+      ::waitpid(worker.pid, &status, 0);
+      worker.pid = -1;
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error("A worker process failed.");
+      }
+    }
+  } catch (...) {
+    killAll(workers);
+    throw;
+  }
+  closeAll(workers);
+}
+
+#endif
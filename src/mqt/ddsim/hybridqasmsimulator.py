@@ -54,6 +54,12 @@ class HybridQasmSimulatorBackend(QasmSimulatorBackend):
             simulator_seed=None,
             mode="amplitude",
             nthreads=local_hardware_info()["cpus"],
+            automatic_split=False,
+            prefix_sharing=False,
+            spill_threshold=None,
+            scratch_directory=None,
+            single_amplitude_buffer=False,
+            nprocesses=1,
         )
 
     @property
@@ -66,6 +72,7 @@ class HybridQasmSimulatorBackend(QasmSimulatorBackend):
         seed = options.get("seed", -1)
         mode = options.get("mode", "amplitude")
         nthreads = int(options.get("nthreads", local_hardware_info()["cpus"]))
+        nprocesses = int(options.get("nprocesses", 1))
         if mode == "amplitude":
             hybrid_mode = HybridMode.amplitude
             max_qubits = 30  # hard-coded 16GiB memory limit
@@ -73,8 +80,14 @@ class HybridQasmSimulatorBackend(QasmSimulatorBackend):
             if algorithm_qubits > max_qubits:
                 msg = "Not enough memory available to simulate the circuit even on a single thread"
                 raise QiskitError(msg)
-            qubit_diff = max_qubits - algorithm_qubits
-            nthreads = int(min(2**qubit_diff, nthreads))
+            max_buffers = 2 ** (max_qubits - algorithm_qubits)
+            if nprocesses > 1:
+                # the coordinator keeps the final amplitudes, while every worker process holds its own buffers
+                nprocesses = int(max(1, min(nprocesses, max_buffers - 1)))
+                max_buffers = max(1, (max_buffers - 1) // nprocesses)
+            if not options.get("single_amplitude_buffer", False):
+                # every thread accumulates its results in a separate buffer
+                nthreads = int(min(max_buffers, nthreads))
         elif mode == "dd":
             hybrid_mode = HybridMode.DD
         else:
@@ -82,16 +95,26 @@ class HybridQasmSimulatorBackend(QasmSimulatorBackend):
             raise QiskitError(msg)
 
         sim = HybridCircuitSimulator(qc, seed=seed, mode=hybrid_mode, nthreads=nthreads)
+        sim.set_automatic_split(bool(options.get("automatic_split", False)))
+        sim.set_prefix_sharing(bool(options.get("prefix_sharing", False)))
+        sim.set_single_amplitude_buffer(bool(options.get("single_amplitude_buffer", False)))
+        sim.set_number_of_processes(nprocesses)
+        spill_threshold = options.get("spill_threshold")
+        if spill_threshold is not None:
+            sim.set_spill_threshold(int(spill_threshold))
+        scratch_directory = options.get("scratch_directory")
+        if scratch_directory is not None:
+            sim.set_scratch_directory(str(scratch_directory))
 
         shots = options.get("shots", 1024)
         if self._SHOW_STATE_VECTOR and shots > 0:
             shots = 0
 
-        counts = sim.simulate(shots)
+        keys, counts = sim.simulate_compact(shots)
         end_time = time.time()
 
         data = ExperimentResultData(
-            counts={hex(int(result, 2)): count for result, count in counts.items()},
+            counts=self._hex_counts(keys, counts),
             statevector=None
             if not self._SHOW_STATE_VECTOR
             else sim.get_vector()
@@ -183,6 +183,8 @@ class PathQasmSimulatorBackend(QasmSimulatorBackend):
             alternating_start=None,
             gate_cost=None,
             seed=None,
+            path_cache=None,
+            nthreads=1,
             cotengra_max_time=60,
             cotengra_max_repeats=1024,
             cotengra_plot_ring=False,
@@ -219,10 +221,15 @@ class PathQasmSimulatorBackend(QasmSimulatorBackend):
         if seed is not None:
             pathsim_configuration.seed = seed
 
+        path_cache: str | None = options.get("path_cache")
+        if path_cache is not None:
+            pathsim_configuration.path_cache = str(path_cache)
+
         sim = PathCircuitSimulator(qc, config=pathsim_configuration)
 
         # determine the contraction path using cotengra in case this is requested
-        if pathsim_configuration.mode == PathSimulatorMode.cotengra:
+        # and no path for a circuit of the same structure has been cached
+        if pathsim_configuration.mode == PathSimulatorMode.cotengra and not sim.is_simulation_path_cached():
             max_time = options.get("cotengra_max_time", 60)
             max_repeats = options.get("cotengra_max_repeats", 1024)
             dump_path = options.get("cotengra_dump_path", False)
@@ -236,6 +243,10 @@ class PathQasmSimulatorBackend(QasmSimulatorBackend):
             )
             sim.set_simulation_path(path, False)
 
+        nthreads = options.get("nthreads", 1)
+        if nthreads is not None:
+            sim.set_number_of_threads(int(nthreads))
+
         shots = options.get("shots", 1024)
         setup_time = time.time()
         counts = sim.simulate(shots)
@@ -52,10 +52,13 @@ class CircuitSimulator:
     def get_max_vector_node_count(self) -> int: ...
     def get_name(self) -> str: ...
     def get_number_of_qubits(self) -> int: ...
+    def get_sampling_threads(self) -> int: ...
     def get_tolerance(self) -> float: ...
     def get_vector(self) -> list[complex]: ...
+    def set_sampling_threads(self, nthreads: int) -> None: ...
     def set_tolerance(self, tol: float) -> None: ...
     def simulate(self, shots: int) -> dict[str, int]: ...
+    def simulate_compact(self, shots: int) -> tuple[NDArray[np.uint64], NDArray[np.uint64]]: ...
     def statistics(self) -> dict[str, str]: ...
 
 class DeterministicNoiseSimulator:
@@ -98,6 +101,7 @@ class DeterministicNoiseSimulator:
     def get_vector(self) -> list[complex]: ...
     def set_tolerance(self, tol: float) -> None: ...
     def simulate(self, shots: int) -> dict[str, int]: ...
+    def simulate_compact(self, shots: int) -> tuple[NDArray[np.uint64], NDArray[np.uint64]]: ...
     def statistics(self) -> dict[str, str]: ...
 
 class HybridMode:
@@ -150,24 +154,50 @@ class HybridCircuitSimulator:
     ) -> str: ...
     def get_active_matrix_node_count(self) -> int: ...
     def get_active_vector_node_count(self) -> int: ...
+    def get_amplitudes(self, bitstrings: list[str]) -> list[complex]: ...
+    def get_applied_operations(self) -> int: ...
+    def get_automatic_split(self) -> bool: ...
     def get_final_amplitudes(self) -> list[complex]: ...
+    def get_max_checkpoints(self) -> int: ...
     def get_max_matrix_node_count(self) -> int: ...
     def get_max_vector_node_count(self) -> int: ...
     def get_mode(self) -> HybridMode: ...
     def get_name(self) -> str: ...
+    def get_number_of_processes(self) -> int: ...
     def get_number_of_qubits(self) -> int: ...
+    def get_prefix_sharing(self) -> bool: ...
+    def get_sampling_threads(self) -> int: ...
+    def get_scratch_directory(self) -> str: ...
+    def get_single_amplitude_buffer(self) -> bool: ...
+    def get_spill_threshold(self) -> int: ...
+    def get_spilled_results(self) -> int: ...
+    def get_split_qubit(self) -> int: ...
+    def get_split_qubits(self) -> list[int]: ...
     def get_tolerance(self) -> float: ...
     def get_vector(self) -> list[complex]: ...
+    def plan_split_qubit(self) -> int: ...
+    def set_automatic_split(self, enable: bool) -> None: ...
+    def set_max_checkpoints(self, max_checkpoints: int) -> None: ...
+    def set_number_of_processes(self, nprocesses: int) -> None: ...
+    def set_prefix_sharing(self, enable: bool) -> None: ...
+    def set_sampling_threads(self, nthreads: int) -> None: ...
+    def set_scratch_directory(self, directory: str) -> None: ...
+    def set_single_amplitude_buffer(self, enable: bool) -> None: ...
+    def set_spill_threshold(self, nodes: int) -> None: ...
+    def set_split_qubits(self, split_qubits: list[int]) -> None: ...
     def set_tolerance(self, tol: float) -> None: ...
     def simulate(self, shots: int) -> dict[str, int]: ...
+    def simulate_compact(self, shots: int) -> tuple[NDArray[np.uint64], NDArray[np.uint64]]: ...
     def statistics(self) -> dict[str, str]: ...
 
 class PathSimulatorMode:
     __members__: ClassVar[
         dict[str, PathSimulatorMode]
-    ]  # value = {'sequential': <PathSimulatorMode.sequential: 0>, 'pairwise_recursive': <PathSimulatorMode.pairwise_recursive: 1>, 'cotengra': <PathSimulatorMode.cotengra: 4>, 'bracket': <PathSimulatorMode.bracket: 2>, 'alternating': <PathSimulatorMode.alternating: 3>, 'gate_cost': <PathSimulatorMode.gate_cost: 5>}
+    ]  # value = {'sequential': <PathSimulatorMode.sequential: 0>, 'pairwise_recursive': <PathSimulatorMode.pairwise_recursive: 1>, 'cotengra': <PathSimulatorMode.cotengra: 4>, 'bracket': <PathSimulatorMode.bracket: 2>, 'alternating': <PathSimulatorMode.alternating: 3>, 'gate_cost': <PathSimulatorMode.gate_cost: 5>, 'cost_model': <PathSimulatorMode.cost_model: 6>, 'adaptive': <PathSimulatorMode.adaptive: 7>}
+    adaptive: ClassVar[PathSimulatorMode]  # value = <PathSimulatorMode.adaptive: 7>
     alternating: ClassVar[PathSimulatorMode]  # value = <PathSimulatorMode.alternating: 3>
     bracket: ClassVar[PathSimulatorMode]  # value = <PathSimulatorMode.bracket: 2>
+    cost_model: ClassVar[PathSimulatorMode]  # value = <PathSimulatorMode.cost_model: 6>
     cotengra: ClassVar[PathSimulatorMode]  # value = <PathSimulatorMode.cotengra: 4>
     gate_cost: ClassVar[PathSimulatorMode]  # value = <PathSimulatorMode.gate_cost: 5>
     pairwise_recursive: ClassVar[PathSimulatorMode]  # value = <PathSimulatorMode.pairwise_recursive: 1>
@@ -205,6 +235,10 @@ class PathSimulatorConfiguration:
     @mode.setter
     def mode(self, arg0: PathSimulatorMode) -> None: ...
     @property
+    def path_cache(self) -> str: ...
+    @path_cache.setter
+    def path_cache(self, arg0: str) -> None: ...
+    @property
     def seed(self) -> int: ...
     @seed.setter
     def seed(self, arg0: int) -> None: ...
@@ -245,15 +279,29 @@ class PathCircuitSimulator:
     ) -> str: ...
     def get_active_matrix_node_count(self) -> int: ...
     def get_active_vector_node_count(self) -> int: ...
+    def get_adaptive_growth_limit(self) -> float: ...
+    def get_gate_cache_capacity(self) -> int: ...
     def get_max_matrix_node_count(self) -> int: ...
     def get_max_vector_node_count(self) -> int: ...
+    def get_memory_aware_scheduling(self) -> bool: ...
     def get_name(self) -> str: ...
     def get_number_of_qubits(self) -> int: ...
+    def get_number_of_threads(self) -> int: ...
+    def get_peak_live_nodes(self) -> int: ...
+    def get_sampling_threads(self) -> int: ...
+    def get_simulation_path(self) -> list[tuple[int, int]]: ...
     def get_tolerance(self) -> float: ...
     def get_vector(self) -> list[complex]: ...
+    def is_simulation_path_cached(self) -> bool: ...
+    def set_adaptive_growth_limit(self, limit: float) -> None: ...
+    def set_gate_cache_capacity(self, capacity: int) -> None: ...
+    def set_memory_aware_scheduling(self, enable: bool) -> None: ...
+    def set_number_of_threads(self, nthreads: int) -> None: ...
+    def set_sampling_threads(self, nthreads: int) -> None: ...
     def set_simulation_path(self, path: list[tuple[int, int]], assume_correct_order: bool = False) -> None: ...
     def set_tolerance(self, tol: float) -> None: ...
     def simulate(self, shots: int) -> dict[str, int]: ...
+    def simulate_compact(self, shots: int) -> tuple[NDArray[np.uint64], NDArray[np.uint64]]: ...
     def statistics(self) -> dict[str, str]: ...
 
 class StochasticNoiseSimulator:
@@ -296,6 +344,7 @@ class StochasticNoiseSimulator:
     def get_vector(self) -> list[complex]: ...
     def set_tolerance(self, tol: float) -> None: ...
     def simulate(self, shots: int) -> dict[str, int]: ...
+    def simulate_compact(self, shots: int) -> tuple[NDArray[np.uint64], NDArray[np.uint64]]: ...
     def statistics(self) -> dict[str, str]: ...
 
 class ConstructionMode:
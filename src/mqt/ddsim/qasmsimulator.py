@@ -21,6 +21,8 @@ from .target import DDSIMTargetBuilder
 if TYPE_CHECKING:
     from collections.abc import Mapping, Sequence
 
+    import numpy as np
+    from numpy.typing import NDArray
     from qiskit.circuit import Parameter
     from qiskit.circuit.parameterexpression import ParameterValueType
 
@@ -144,6 +146,14 @@ class QasmSimulatorBackend(BackendV2):  # type: ignore[misc]
     def _validate(self, quantum_circuits: Sequence[QuantumCircuit]) -> None:
         pass
 
+    @staticmethod
+    def _hex_counts(keys: NDArray[np.uint64], counts: NDArray[np.uint64]) -> dict[str, int]:
+        """Convert the result of ``simulate_compact`` to Qiskit's hexadecimal counts."""
+        return {
+            hex(sum(int(word) << (64 * i) for i, word in enumerate(key))): int(count)
+            for key, count in zip(keys, counts)
+        }
+
     def _run_job(
         self,
         job_id: int,
@@ -185,11 +195,11 @@ class QasmSimulatorBackend(BackendV2):  # type: ignore[misc]
             approximation_strategy=approximation_strategy,
             seed=seed,
         )
-        counts = sim.simulate(shots=shots)
+        keys, counts = sim.simulate_compact(shots=shots)
         end_time = time.time()
 
         data = ExperimentResultData(
-            counts={hex(int(result, 2)): count for result, count in counts.items()},
+            counts=self._hex_counts(keys, counts),
             statevector=None if not self._SHOW_STATE_VECTOR else sim.get_vector(),
             time_taken=end_time - start_time,
         )
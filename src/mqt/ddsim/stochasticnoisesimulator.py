@@ -68,11 +68,11 @@ class StochasticNoiseSimulatorBackend(QasmSimulatorBackend):
             multi_qubit_gate_factor=multi_qubit_gate_factor,
         )
 
-        counts = sim.simulate(shots=shots)
+        keys, counts = sim.simulate_compact(shots=shots)
         end_time = time.time()
 
         data = ExperimentResultData(
-            counts={hex(int(result, 2)): count for result, count in counts.items()},
+            counts=self._hex_counts(keys, counts),
             statevector=None,
             time_taken=end_time - start_time,
         )
@@ -7,13 +7,17 @@
 #include "CircuitSimulator.hpp"
 #include "DeterministicNoiseSimulator.hpp"
 #include "HybridSchrodingerFeynmanSimulator.hpp"
+#include "PackedBitString.hpp"
 #include "PathSimulator.hpp"
 #include "StochasticNoiseSimulator.hpp"
 #include "UnitarySimulator.hpp"
 #include "dd/FunctionalityConstruction.hpp"
 #include "python/qiskit/QuantumCircuit.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <pybind11/complex.h>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -120,6 +124,25 @@ void getNumPyMatrix(UnitarySimulator& sim,
                     sim.getNumberOfQubits());
 }
 
+py::tuple toNumPyHistogram(const PackedHistogram& histogram) {
+  const auto entries = static_cast<py::ssize_t>(histogram.size());
+  const auto words = static_cast<py::ssize_t>(
+      histogram.empty() ? 0U : histogram.begin()->first.size());
+  py::array_t<std::uint64_t> keys({entries, words});
+  py::array_t<std::uint64_t> counts(entries);
+  auto keysView = keys.mutable_unchecked<2>();
+  auto countsView = counts.mutable_unchecked<1>();
+  py::ssize_t i = 0;
+  for (const auto& [bits, count] : histogram) {
+    for (py::ssize_t w = 0; w < words; ++w) {
+      keysView(i, w) = bits[static_cast<std::size_t>(w)];
+    }
+    countsView(i) = count;
+    ++i;
+  }
+  return py::make_tuple(keys, counts);
+}
+
 void dumpTensorNetwork(const py::object& circ, const std::string& filename) {
   const py::object quantumCircuit =
       py::module::import("qiskit").attr("QuantumCircuit");
@@ -187,12 +210,33 @@ py::class_<Sim> createSimulator(py::module_ m, const std::string& name) {
     sim.def("simulate", &Sim::simulate, "shots"_a,
             "Simulate the circuit and return the result as a dictionary of "
             "counts.");
+    sim.def(
+        "simulate_compact",
+        [](Sim& simulator, const std::size_t shots) {
+          return toNumPyHistogram(simulator.simulateCompact(shots));
+        },
+        "shots"_a,
+        "Simulate the circuit and return the result as a tuple of NumPy "
+        "arrays `(keys, counts)`. Each row of `keys` holds one outcome packed "
+        "into 64-bit words, least significant word first.");
     sim.def("get_vector", &Sim::getVector,
             "Get the state vector resulting from the simulation.");
   }
   return sim;
 }
 
+// only for simulators that sample from the DD of their final state
+template <class Sim>
+void defineSamplingThreads(py::class_<Sim>& sim, const std::string& note = "") {
+  sim.def("get_sampling_threads", &Sim::getSamplingThreads,
+          "Get the number of threads used for sampling the final state.");
+  sim.def("set_sampling_threads", &Sim::setSamplingThreads, "nthreads"_a,
+          ("Set the number of threads used for sampling the final state (0 "
+           "for serial sampling)." +
+           note)
+              .c_str());
+}
+
 PYBIND11_MODULE(pyddsim, m, py::mod_gil_not_used()) {
   m.doc() = "Python interface for the MQT DDSIM quantum circuit simulator";
 
@@ -204,6 +248,7 @@ PYBIND11_MODULE(pyddsim, m, py::mod_gil_not_used()) {
            "approximation_step_fidelity"_a = 1., "approximation_steps"_a = 1,
            "approximation_strategy"_a = "fidelity", "seed"_a = -1)
       .def("expectation_value", &expectationValue, "observable"_a);
+  defineSamplingThreads(circuitSimulator);
 
   // Stoch simulator
   auto stochasticNoiseSimulator =
@@ -247,8 +292,58 @@ PYBIND11_MODULE(pyddsim, m, py::mod_gil_not_used()) {
            "mode"_a = HybridSchrodingerFeynmanSimulator<>::Mode::Amplitude,
            "nthreads"_a = 2)
       .def("get_mode", &HybridSchrodingerFeynmanSimulator<>::getMode)
+      .def("set_automatic_split",
+           &HybridSchrodingerFeynmanSimulator<>::setAutomaticSplit, "enable"_a)
+      .def("get_automatic_split",
+           &HybridSchrodingerFeynmanSimulator<>::getAutomaticSplit)
+      .def("plan_split_qubit",
+           &HybridSchrodingerFeynmanSimulator<>::planSplitQubit)
+      .def("get_split_qubit",
+           &HybridSchrodingerFeynmanSimulator<>::getSplitQubit)
+      .def("set_split_qubits",
+           &HybridSchrodingerFeynmanSimulator<>::setSplitQubits,
+           "split_qubits"_a)
+      .def("get_split_qubits",
+           &HybridSchrodingerFeynmanSimulator<>::getSplitQubits)
+      .def("set_prefix_sharing",
+           &HybridSchrodingerFeynmanSimulator<>::setPrefixSharing, "enable"_a)
+      .def("get_prefix_sharing",
+           &HybridSchrodingerFeynmanSimulator<>::getPrefixSharing)
+      .def("set_max_checkpoints",
+           &HybridSchrodingerFeynmanSimulator<>::setMaxCheckpoints,
+           "max_checkpoints"_a)
+      .def("get_max_checkpoints",
+           &HybridSchrodingerFeynmanSimulator<>::getMaxCheckpoints)
+      .def("get_applied_operations",
+           &HybridSchrodingerFeynmanSimulator<>::getAppliedOperations)
+      .def("set_spill_threshold",
+           &HybridSchrodingerFeynmanSimulator<>::setSpillThreshold, "nodes"_a)
+      .def("get_spill_threshold",
+           &HybridSchrodingerFeynmanSimulator<>::getSpillThreshold)
+      .def("set_scratch_directory",
+           &HybridSchrodingerFeynmanSimulator<>::setScratchDirectory,
+           "directory"_a)
+      .def("get_scratch_directory",
+           &HybridSchrodingerFeynmanSimulator<>::getScratchDirectory)
+      .def("get_spilled_results",
+           &HybridSchrodingerFeynmanSimulator<>::getSpilledResults)
+      .def("set_single_amplitude_buffer",
+           &HybridSchrodingerFeynmanSimulator<>::setSingleAmplitudeBuffer,
+           "enable"_a)
+      .def("get_single_amplitude_buffer",
+           &HybridSchrodingerFeynmanSimulator<>::getSingleAmplitudeBuffer)
+      .def("get_amplitudes",
+           &HybridSchrodingerFeynmanSimulator<>::getAmplitudes, "bitstrings"_a)
+      .def("set_number_of_processes",
+           &HybridSchrodingerFeynmanSimulator<>::setNumberOfProcesses,
+           "nprocesses"_a)
+      .def("get_number_of_processes",
+           &HybridSchrodingerFeynmanSimulator<>::getNumberOfProcesses)
       .def("get_final_amplitudes",
            &HybridSchrodingerFeynmanSimulator<>::getVectorFromHybridSimulation);
+  defineSamplingThreads(hsfSimulator,
+                        " Only affects the DD mode, as the amplitude mode "
+                        "samples from the final amplitudes.");
 
   // Path Simulator
   py::enum_<PathSimulator<>::Configuration::Mode>(m, "PathSimulatorMode")
@@ -259,6 +354,8 @@ PYBIND11_MODULE(pyddsim, m, py::mod_gil_not_used()) {
       .value("bracket", PathSimulator<>::Configuration::Mode::BracketGrouping)
       .value("alternating", PathSimulator<>::Configuration::Mode::Alternating)
       .value("gate_cost", PathSimulator<>::Configuration::Mode::GateCost)
+      .value("cost_model", PathSimulator<>::Configuration::Mode::CostModel)
+      .value("adaptive", PathSimulator<>::Configuration::Mode::Adaptive)
       .export_values()
       .def(py::init(
           [](const std::string& str) -> PathSimulator<>::Configuration::Mode {
@@ -283,6 +380,9 @@ PYBIND11_MODULE(pyddsim, m, py::mod_gil_not_used()) {
           R"pbdoc(A list that contains the number of gates which are considered in each step)pbdoc")
       .def_readwrite("seed", &PathSimulator<>::Configuration::seed,
                      R"pbdoc(Seed for the simulator)pbdoc")
+      .def_readwrite(
+          "path_cache", &PathSimulator<>::Configuration::pathCache,
+          R"pbdoc(Directory of the persistent simulation path cache (disabled if empty))pbdoc")
       .def("json", &PathSimulator<>::Configuration::json)
       .def("__repr__", &PathSimulator<>::Configuration::toString);
 
@@ -304,7 +404,31 @@ PYBIND11_MODULE(pyddsim, m, py::mod_gil_not_used()) {
       .def("set_simulation_path",
            py::overload_cast<const PathSimulator<>::SimulationPath::Components&,
                              bool>(&PathSimulator<>::setSimulationPath),
-           "path"_a, "assume_correct_order"_a = false);
+           "path"_a, "assume_correct_order"_a = false)
+      .def(
+          "get_simulation_path",
+          [](const PathSimulator<>& sim) {
+            return sim.getSimulationPath().components;
+          },
+          "Get the simulation path, e.g., the one chosen in the adaptive mode")
+      .def("set_memory_aware_scheduling",
+           &PathSimulator<>::setMemoryAwareScheduling, "enable"_a)
+      .def("get_memory_aware_scheduling",
+           &PathSimulator<>::getMemoryAwareScheduling)
+      .def("get_peak_live_nodes", &PathSimulator<>::getPeakLiveNodes)
+      .def("set_gate_cache_capacity", &PathSimulator<>::setGateCacheCapacity,
+           "capacity"_a)
+      .def("get_gate_cache_capacity", &PathSimulator<>::getGateCacheCapacity)
+      .def("is_simulation_path_cached",
+           &PathSimulator<>::isSimulationPathCached)
+      .def("set_adaptive_growth_limit",
+           &PathSimulator<>::setAdaptiveGrowthLimit, "limit"_a)
+      .def("get_adaptive_growth_limit",
+           &PathSimulator<>::getAdaptiveGrowthLimit)
+      .def("set_number_of_threads", &PathSimulator<>::setNumberOfThreads,
+           "nthreads"_a)
+      .def("get_number_of_threads", &PathSimulator<>::getNumberOfThreads);
+  defineSamplingThreads(pathSimulator);
 
   // Unitary Simulator
   py::enum_<UnitarySimulator::Mode>(m, "ConstructionMode")
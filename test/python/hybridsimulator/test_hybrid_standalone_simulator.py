@@ -37,3 +37,12 @@ class MQTStandaloneHybridSimulatorTest(unittest.TestCase):
         sim = HybridCircuitSimulator(self.circuit, seed=1337, mode=HybridMode.DD)
         result = sim.simulate(2048)
         assert len(result.keys()) == self.non_zeros_in_matrix
+
+    def test_standalone_get_amplitudes(self) -> None:
+        sim = HybridCircuitSimulator(self.circuit, mode=HybridMode.amplitude)
+        amplitudes = sim.get_amplitudes(["0000", "1010", "1111"])
+        assert len(amplitudes) == 3
+        # the CZ gates only flip signs within the uniform superposition
+        assert abs(amplitudes[0] - 0.25) < 1e-8
+        assert abs(amplitudes[1] + 0.25) < 1e-8
+        assert abs(amplitudes[2] - 0.25) < 1e-8
@@ -45,6 +45,37 @@ class MQTStandaloneSimulatorTests(unittest.TestCase):
         assert "000" in result
         assert "111" in result
 
+    def test_standalone_parallel_sampling(self) -> None:
+        circ = QuantumCircuit(3)
+        circ.h(0)
+        circ.cx(0, 1)
+        circ.cx(0, 2)
+
+        results = []
+        for nthreads in (1, 4):
+            sim = CircuitSimulator(circ, seed=1337)
+            sim.set_sampling_threads(nthreads)
+            assert sim.get_sampling_threads() == nthreads
+            results.append(sim.simulate(200000))
+        assert results[0] == results[1]
+        assert len(results[0].keys()) == self.nonzero_states_ghz
+        assert sum(results[0].values()) == 200000
+
+    def test_standalone_compact_result(self) -> None:
+        circ = QuantumCircuit(3)
+        circ.h(0)
+        circ.cx(0, 1)
+        circ.cx(0, 2)
+
+        sim = CircuitSimulator(circ, seed=1337)
+        keys, counts = sim.simulate_compact(1000)
+        assert keys.shape == (self.nonzero_states_ghz, 1)
+        assert sorted(keys[:, 0].tolist()) == [0b000, 0b111]
+        assert int(counts.sum()) == 1000
+
+        reference = CircuitSimulator(circ, seed=1337).simulate(1000)
+        assert {format(int(key[0]), "03b"): int(count) for key, count in zip(keys, counts)} == reference
+
     def test_standalone_simple_approximation(self) -> None:
         import numpy as np
 
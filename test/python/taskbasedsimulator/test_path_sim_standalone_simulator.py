@@ -27,6 +27,20 @@ class MQTStandaloneSimulatorTests(unittest.TestCase):
         assert "000" in result
         assert "111" in result
 
+    def test_standalone_parallel(self) -> None:
+        circ = QuantumCircuit(3)
+        circ.h(0)
+        circ.cx(0, 1)
+        circ.cx(0, 2)
+
+        sim = PathCircuitSimulator(circ, mode=PathSimulatorMode.pairwise_recursive)
+        sim.set_number_of_threads(2)
+        assert sim.get_number_of_threads() == 2
+        result = sim.simulate(1000)
+        assert len(result.keys()) == self.nonzero_states_ghz
+        assert "000" in result
+        assert "111" in result
+
     def test_standalone_with_config(self) -> None:
         circ = QuantumCircuit(3)
         circ.h(0)
@@ -0,0 +1,79 @@
+#include "AliasSampler.hpp"
+#include "CircuitSimulator.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+TEST(AliasSamplerTest, ReproducesDistribution) {
+  const std::vector<dd::fp> weights{0., 4., 7., 1., 0., 3., 0.5, 2.};
+  dd::fp total = 0.;
+  for (const auto w : weights) {
+    total += w;
+  }
+
+  const AliasSampler sampler(weights);
+  ASSERT_EQ(sampler.size(), weights.size());
+  std::mt19937_64 mt(1337U);
+  constexpr std::size_t shots = 200000;
+  const auto histogram = sampler.sample(shots, mt);
+
+  for (std::size_t i = 0; i < weights.size(); ++i) {
+    const auto it = histogram.find(i);
+    if (weights[i] == 0.) {
+      EXPECT_TRUE(it == histogram.end());
+      continue;
+    }
+    ASSERT_TRUE(it != histogram.end());
+    EXPECT_NEAR(static_cast<double>(it->second) / shots, weights[i] / total,
+                0.01);
+  }
+}
+
+TEST(AliasSamplerTest, SingleOutcome) {
+  const AliasSampler sampler(std::vector<dd::fp>{0., 0., 1., 0.});
+  std::mt19937_64 mt(42U);
+  const auto histogram = sampler.sample(1000, mt);
+  ASSERT_EQ(histogram.size(), 1);
+  EXPECT_EQ(histogram.at(2), 1000);
+}
+
+TEST(AliasSamplerTest, FromAmplitudes) {
+  std::vector<std::complex<dd::fp>> amplitudes{
+      {0., 0.}, {std::sqrt(0.25), 0.}, {0., std::sqrt(0.75)}, {0., 0.}};
+  const AliasSampler sampler(std::move(amplitudes));
+  std::mt19937_64 mt(42U);
+  constexpr std::size_t shots = 100000;
+  const auto histogram = sampler.sample(shots, mt);
+  ASSERT_EQ(histogram.size(), 2);
+  EXPECT_NEAR(static_cast<double>(histogram.at(1)) / shots, 0.25, 0.01);
+  EXPECT_NEAR(static_cast<double>(histogram.at(2)) / shots, 0.75, 0.01);
+}
+
+TEST(AliasSamplerTest, ZeroDistributionThrows) {
+  EXPECT_THROW(AliasSampler(std::vector<dd::fp>{0., 0.}), std::runtime_error);
+  EXPECT_THROW(AliasSampler(std::vector<dd::fp>{}), std::runtime_error);
+}
+
+TEST(AliasSamplerTest, SampleFromAmplitudeVector) {
+  auto qc = std::make_unique<qc::QuantumComputation>(3);
+  qc->h(0);
+  qc->cx(0, 1);
+  qc->cx(0, 2);
+  CircuitSimulator ddsim(std::move(qc), 1337);
+  ddsim.simulate(0);
+
+  auto amplitudes = ddsim.getVector();
+  const auto result = ddsim.sampleFromAmplitudeVectorInPlace(amplitudes, 4096);
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_NEAR(static_cast<double>(result.at("000")), 2048, 128);
+  EXPECT_NEAR(static_cast<double>(result.at("111")), 2048, 128);
+}
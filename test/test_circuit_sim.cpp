@@ -1,5 +1,6 @@
 #include "CircuitSimulator.hpp"
 #include "Definitions.hpp"
+#include "PackedBitString.hpp"
 #include "algorithms/BernsteinVazirani.hpp"
 #include "algorithms/Grover.hpp"
 #include "algorithms/QFT.hpp"
@@ -13,6 +14,7 @@
 #include <cstdlib>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -369,3 +371,261 @@ TEST(CircuitSimTest, GetVectorBeforeSimulate) {
   const auto vec = ddsim.getVector();
   EXPECT_EQ(vec[0], 1.);
 }
+
+TEST(CircuitSimTest, GateFusion) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    qc->h(0);
+    qc->cx(0, 1);
+    qc->rz(0.3, 1);
+    qc->h(2);
+    qc->cx(2, 3);
+    qc->cx(1, 2);
+    qc->ry(0.7, 3);
+    qc->barrier();
+    qc->cx(3, 0);
+    return qc;
+  };
+
+  CircuitSimulator reference(quantumComputation());
+  reference.simulate(0);
+  const auto expected = reference.getVector();
+
+  CircuitSimulator ddsim(quantumComputation());
+  ddsim.setMaxFusionQubits(2);
+  ddsim.simulate(0);
+  const auto actual = ddsim.getVector();
+
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_NEAR(actual[i].real(), expected[i].real(), 1e-10);
+    EXPECT_NEAR(actual[i].imag(), expected[i].imag(), 1e-10);
+  }
+
+  const auto stats = ddsim.additionalStatistics();
+  EXPECT_EQ(stats.at("fused_gates"), "7");
+  EXPECT_EQ(stats.at("unfused_gates"), "1");
+  EXPECT_EQ(reference.additionalStatistics().at("fused_gates"), "0");
+}
+
+TEST(CircuitSimTest, GateFusionDynamicCircuit) {
+  auto qc = std::make_unique<qc::QuantumComputation>(2, 2);
+  qc->h(0);
+  qc->cx(0, 1);
+  qc->measure(0, 0);
+  qc->x(1);
+  qc->measure(1, 1);
+  CircuitSimulator ddsim(std::move(qc), 1337);
+  ddsim.setMaxFusionQubits(2);
+  const auto result = ddsim.simulate(1024);
+
+  // the measurements are anti-correlated after the final X gate
+  for (const auto& [bits, count] : result) {
+    EXPECT_TRUE(bits == "10" || bits == "01");
+  }
+  EXPECT_EQ(ddsim.additionalStatistics().at("fused_gates"), "2048");
+}
+
+TEST(CircuitSimTest, ParallelDynamicShotsReproducible) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(3, 3);
+    qc->h(0);
+    qc->cx(0, 1);
+    qc->measure(0, 0);
+    qc->h(2);
+    qc->reset(0);
+    qc->h(0);
+    qc->measure(0, 1);
+    qc->measure(2, 2);
+    return qc;
+  };
+
+  CircuitSimulator oneThread(quantumComputation(), 42);
+  oneThread.setShotThreads(1);
+  const auto expected = oneThread.simulate(1000);
+
+  CircuitSimulator fourThreads(quantumComputation(), 42);
+  fourThreads.setShotThreads(4);
+  const auto actual = fourThreads.simulate(1000);
+
+  EXPECT_EQ(actual, expected);
+  EXPECT_EQ(fourThreads.additionalStatistics().at("single_shots"), "1000");
+
+  std::size_t total = 0;
+  for (const auto& [bits, count] : actual) {
+    EXPECT_EQ(bits.size(), 3);
+    total += count;
+  }
+  EXPECT_EQ(total, 1000);
+  EXPECT_EQ(actual.size(), 8);
+}
+
+TEST(CircuitSimTest, PrefixCachingDynamicCircuit) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(3, 2);
+    qc->h(0);
+    qc->cx(0, 1);
+    qc->ry(0.4, 2);
+    qc->cx(1, 2);
+    qc->measure(0, 0);
+    qc->h(0);
+    qc->measure(0, 1);
+    return qc;
+  };
+
+  CircuitSimulator withoutCache(quantumComputation(), 1337);
+  EXPECT_FALSE(withoutCache.getPrefixCaching());
+  const auto expected = withoutCache.simulate(256);
+  EXPECT_EQ(withoutCache.additionalStatistics().at("prefix_cache_hits"), "0");
+
+  CircuitSimulator withCache(quantumComputation(), 1337);
+  withCache.setPrefixCaching(true);
+  const auto actual = withCache.simulate(256);
+  EXPECT_EQ(withCache.additionalStatistics().at("prefix_cache_hits"), "255");
+
+  // the prefix does not consume any randomness, so results must be identical
+  EXPECT_EQ(actual, expected);
+}
+
+TEST(CircuitSimTest, MeasurementBranchingExactDistribution) {
+  auto qc = std::make_unique<qc::QuantumComputation>(2, 2);
+  qc->ry(qc::PI / 3, 0);
+  qc->measure(0, 0);
+  qc->classicControlled(qc::X, 1U, qc->getCregs().at("c"), 1U);
+  qc->measure(1, 1);
+
+  CircuitSimulator ddsim(std::move(qc), 42);
+  ddsim.setMeasurementBranching(true);
+  const auto result = ddsim.simulate(4096);
+
+  const auto& probabilities = ddsim.getOutcomeProbabilities();
+  ASSERT_EQ(probabilities.size(), 2);
+  EXPECT_NEAR(probabilities.at("00"), 0.75, 1e-10);
+  EXPECT_NEAR(probabilities.at("11"), 0.25, 1e-10);
+  EXPECT_NEAR(static_cast<double>(result.at("11")), 1024, 128);
+  EXPECT_EQ(ddsim.additionalStatistics().at("single_shots"), "0");
+  EXPECT_EQ(ddsim.additionalStatistics().at("outcome_branches"), "2");
+}
+
+TEST(CircuitSimTest, MeasurementBranchingSharesSubtrees) {
+  auto qc = std::make_unique<qc::QuantumComputation>(1, 1);
+  qc->h(0);
+  qc->reset(0);
+  qc->h(0);
+  qc->measure(0, 0);
+
+  CircuitSimulator ddsim(std::move(qc), 42);
+  ddsim.setMeasurementBranching(true);
+  ddsim.simulate(1024);
+
+  // both outcomes of the reset lead to the same state
+  EXPECT_EQ(ddsim.additionalStatistics().at("branch_memo_hits"), "1");
+  EXPECT_EQ(ddsim.additionalStatistics().at("outcome_branches"), "2");
+  EXPECT_NEAR(ddsim.getOutcomeProbabilities().at("1"), 0.5, 1e-10);
+}
+
+TEST(CircuitSimTest, MeasurementBranchingPruning) {
+  auto qc = std::make_unique<qc::QuantumComputation>(2, 2);
+  qc->ry(qc::PI / 3, 0);
+  qc->measure(0, 0);
+  qc->h(1);
+  qc->measure(1, 1);
+
+  CircuitSimulator ddsim(std::move(qc), 42);
+  ddsim.setMeasurementBranching(true, 0.3);
+  const auto result = ddsim.simulate(100);
+
+  EXPECT_EQ(ddsim.additionalStatistics().at("pruned_branches"), "1");
+  EXPECT_EQ(result.size(), 2);
+  EXPECT_EQ(result.count("01"), 0);
+  EXPECT_EQ(result.count("11"), 0);
+}
+
+TEST(CircuitSimTest, SimulateCompactMatchesSimulate) {
+  const auto buildCircuit = []() {
+    auto qc = std::make_unique<qc::QuantumComputation>(3, 2);
+    qc->h(0);
+    qc->cx(0, 1);
+    qc->x(2);
+    qc->measure(2, 0);
+    qc->measure(0, 1);
+    return qc;
+  };
+
+  CircuitSimulator ddsim(buildCircuit(), 1337);
+  const auto result = ddsim.simulate(1024);
+  CircuitSimulator compactSim(buildCircuit(), 1337);
+  const auto compact = compactSim.simulateCompact(1024);
+
+  ASSERT_EQ(compact.size(), 2);
+  EXPECT_EQ(toStringHistogram(compact, 2), result);
+  EXPECT_EQ(compact.count(PackedBitString{0b01U}), 1);
+  EXPECT_EQ(compact.count(PackedBitString{0b11U}), 1);
+}
+
+TEST(CircuitSimTest, SimulateCompactDynamicCircuit) {
+  auto qc = std::make_unique<qc::QuantumComputation>(1, 1);
+  qc->x(0);
+  qc->measure(0, 0);
+  qc->reset(0);
+  CircuitSimulator ddsim(std::move(qc), 42);
+  const auto compact = ddsim.simulateCompact(16);
+  ASSERT_EQ(compact.size(), 1);
+  EXPECT_EQ(compact.at(PackedBitString{1U}), 16);
+}
+
+namespace {
+std::unique_ptr<qc::QuantumComputation> budgetTestCircuit() {
+  constexpr std::size_t nqubits = 8;
+  auto qc = std::make_unique<qc::QuantumComputation>(nqubits);
+  for (qc::Qubit q = 0; q < nqubits; ++q) {
+    qc->h(q);
+  }
+  for (std::size_t layer = 0; layer < 3; ++layer) {
+    for (qc::Qubit q = 0; q < nqubits; ++q) {
+      qc->rz(0.1 * static_cast<double>((layer + 1) * (q + 1)), q);
+      qc->ry(0.3 * static_cast<double>(q + layer + 1), q);
+    }
+    for (qc::Qubit q = 0; q + 1 < nqubits; ++q) {
+      qc->cx(q, q + 1);
+    }
+  }
+  return qc;
+}
+} // namespace
+
+TEST(CircuitSimTest, MemoryBudgetNotExceeded) {
+  // a budget that is never reached only tracks the peak memory
+  CircuitSimulator unbudgeted(budgetTestCircuit(), 42);
+  unbudgeted.setMemoryBudget(std::numeric_limits<std::size_t>::max());
+  unbudgeted.simulate(16);
+  const auto unbudgetedPeak = unbudgeted.getPeakMemory();
+  ASSERT_GT(unbudgetedPeak, 0);
+  EXPECT_EQ(unbudgeted.additionalStatistics().at("budget_garbage_collections"),
+            "0");
+
+  CircuitSimulator ddsim(budgetTestCircuit(), 42);
+  ddsim.setMemoryBudget(unbudgetedPeak - 1);
+  ddsim.simulate(16);
+
+  const auto stats = ddsim.additionalStatistics();
+  EXPECT_NE(stats.at("budget_garbage_collections"), "0");
+  EXPECT_EQ(stats.at("budget_violations"), "0");
+  EXPECT_GT(ddsim.getPeakMemory(), 0);
+  EXPECT_LE(ddsim.getPeakMemory(), ddsim.getMemoryBudget());
+}
+
+TEST(CircuitSimTest, MemoryBudgetEscalatesToApproximation) {
+  CircuitSimulator ddsim(budgetTestCircuit(), 42);
+  // a budget this small can never be met
+  ddsim.setMemoryBudget(1, 0.9);
+  ddsim.simulate(16);
+
+  const auto stats = ddsim.additionalStatistics();
+  EXPECT_NE(stats.at("budget_garbage_collections"), "0");
+  EXPECT_NE(stats.at("budget_compute_table_flushes"), "0");
+  EXPECT_NE(stats.at("budget_approximations"), "0");
+  EXPECT_NE(stats.at("budget_violations"), "0");
+  EXPECT_GT(std::stod(stats.at("budget_fidelity_loss")), 0.);
+  EXPECT_LT(std::stod(stats.at("final_fidelity")), 1.);
+}
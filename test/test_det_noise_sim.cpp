@@ -1,4 +1,5 @@
 #include "DeterministicNoiseSimulator.hpp"
+#include "PackedBitString.hpp"
 #include "ir/QuantumComputation.hpp"
 #include "ir/operations/OpType.hpp"
 
@@ -377,3 +378,24 @@ TEST(DeterministicNoiseSimTest, TestSimulateInterfaceWithMeasurements) {
                 expectedValues.at(i), tolerance);
   }
 }
+
+TEST(DeterministicNoiseSimTest, TestSimulateCompactInterface) {
+  auto quantumComputation = detGetAdder4Circuit();
+  auto ddsim = std::make_unique<DeterministicNoiseSimulator>(
+      std::move(quantumComputation), std::string("APD"), 0.01, 0.02, 1);
+
+  // the samples have to be drawn from the density matrix
+  const auto m = toStringHistogram(ddsim->simulateCompact(10000), 4);
+
+  const auto expectedEntries = std::array{"0000", "0001", "1000", "1001"};
+  const auto expectedValues = std::array{616, 1487, 570, 5519};
+  const double tolerance = 500;
+  for (std::size_t i = 0; i < expectedEntries.size(); ++i) {
+    if (m.count(expectedEntries.at(i)) == 0) {
+      FAIL() << "Expected entry " << expectedEntries.at(i)
+             << " not found in result";
+    }
+    EXPECT_NEAR(static_cast<double>(m.at(expectedEntries.at(i))),
+                expectedValues.at(i), tolerance);
+  }
+}
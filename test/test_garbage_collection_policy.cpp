@@ -0,0 +1,95 @@
+#include "CircuitSimulator.hpp"
+#include "GarbageCollectionPolicy.hpp"
+#include "StochasticNoiseSimulator.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace {
+std::unique_ptr<qc::QuantumComputation> gcTestCircuit() {
+  auto qc = std::make_unique<qc::QuantumComputation>(4);
+  for (std::size_t layer = 0; layer < 5; ++layer) {
+    for (qc::Qubit q = 0; q < 4; ++q) {
+      qc->h(q);
+    }
+    for (qc::Qubit q = 0; q < 3; ++q) {
+      qc->cx(q, q + 1);
+    }
+  }
+  return qc; // 35 operations
+}
+} // namespace
+
+TEST(GarbageCollectionPolicyTest, DefaultCollectsAfterEveryOperation) {
+  CircuitSimulator ddsim(gcTestCircuit(), 42);
+  EXPECT_EQ(ddsim.getGarbageCollectionPolicy().getStrategy(),
+            GarbageCollectionPolicy::Strategy::EveryOperation);
+  ddsim.simulate(16);
+  const auto stats = ddsim.additionalStatistics();
+  // operations after which the package does not need a collection are skipped
+  // without any bookkeeping
+  EXPECT_EQ(std::stoul(stats.at("gc_runs")) +
+                std::stoul(stats.at("gc_skipped")),
+            35U);
+  EXPECT_GE(std::stod(stats.at("gc_time")), 0.);
+}
+
+TEST(GarbageCollectionPolicyTest, EveryKOperations) {
+  CircuitSimulator ddsim(gcTestCircuit(), 42);
+  ddsim.setGarbageCollectionPolicy(
+      GarbageCollectionPolicy::everyKOperations(5));
+  ddsim.simulate(16);
+  const auto stats = ddsim.additionalStatistics();
+  EXPECT_EQ(stats.at("gc_runs"), "7");
+  EXPECT_EQ(stats.at("gc_skipped"), "28");
+}
+
+TEST(GarbageCollectionPolicyTest, NodeThresholdNeverReached) {
+  CircuitSimulator ddsim(gcTestCircuit(), 42);
+  ddsim.setGarbageCollectionPolicy(
+      GarbageCollectionPolicy::nodeThreshold(1ULL << 40U));
+  ddsim.simulate(16);
+  EXPECT_EQ(ddsim.additionalStatistics().at("gc_runs"), "0");
+}
+
+TEST(GarbageCollectionPolicyTest, BytesThresholdAlwaysReached) {
+  CircuitSimulator ddsim(gcTestCircuit(), 42);
+  ddsim.setGarbageCollectionPolicy(GarbageCollectionPolicy::bytesThreshold(1));
+  ddsim.simulate(16);
+  const auto stats = ddsim.additionalStatistics();
+  EXPECT_GT(std::stoul(stats.at("gc_runs")), 0U);
+  EXPECT_NE(stats.at("gc_effective_runs"), "0");
+}
+
+TEST(GarbageCollectionPolicyTest, PolicyDoesNotChangeResult) {
+  CircuitSimulator reference(gcTestCircuit(), 1337);
+  const auto expected = reference.simulate(1024);
+
+  for (const auto& policy : {GarbageCollectionPolicy::everyKOperations(3),
+                             GarbageCollectionPolicy::nodeThreshold(16),
+                             GarbageCollectionPolicy::adaptive(8)}) {
+    CircuitSimulator ddsim(gcTestCircuit(), 1337);
+    ddsim.setGarbageCollectionPolicy(policy);
+    EXPECT_EQ(ddsim.simulate(1024), expected);
+  }
+}
+
+TEST(GarbageCollectionPolicyTest, StochasticSimulatorMergesStatistics) {
+  auto qc = std::make_unique<qc::QuantumComputation>(2, 2);
+  qc->h(0);
+  qc->cx(0, 1);
+  qc->measure(0, 0);
+  qc->measure(1, 1);
+  StochasticNoiseSimulator ddsim(std::move(qc), ApproximationInfo{}, 42, "APD",
+                                 0.01, std::nullopt, 2);
+  ddsim.setGarbageCollectionPolicy(
+      GarbageCollectionPolicy::everyKOperations(2));
+  ddsim.simulate(10);
+  // every run applies two gates, i.e., the policy triggers once per run
+  EXPECT_EQ(ddsim.additionalStatistics().at("gc_runs"), "10");
+}
@@ -1,17 +1,41 @@
 #include "CircuitSimulator.hpp"
 #include "HybridSchrodingerFeynmanSimulator.hpp"
+#include "WorkerPool.hpp"
+#include "dd/DDDefinitions.hpp"
 #include "ir/QuantumComputation.hpp"
 #include "ir/operations/OpType.hpp"
 
+#include <cstddef>
 #include <cstdlib>
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 using namespace qc::literals;
 
+namespace {
+void expectSameVector(const dd::CVec& expected, const dd::CVec& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(expected[i].real(), actual[i].real(), 1e-8);
+    EXPECT_NEAR(expected[i].imag(), actual[i].imag(), 1e-8);
+  }
+}
+
+// the state vector obtained by simulating the circuit without any cuts
+dd::CVec referenceVector(std::unique_ptr<qc::QuantumComputation> qc) {
+  CircuitSimulator reference(std::move(qc));
+  reference.simulate(1);
+  return reference.getVector();
+}
+} // namespace
+
 TEST(HybridSimTest, TrivialParallelDD) {
   auto quantumComputation = [] {
     auto qc = std::make_unique<qc::QuantumComputation>(4);
@@ -206,28 +230,397 @@ TEST(HybridSimTest, DynamicCircuitSupport) {
 }
 
 TEST(HybridSimTest, TwoTargetGateSupport) {
-  auto qc = std::make_unique<qc::QuantumComputation>(2);
-  qc->rzz(1., 0, 1);
-  std::cout << *qc << "\n";
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(2);
+    qc->h(0);
+    qc->h(1);
+    qc->rzz(1., 0, 1);
+    return qc;
+  };
 
-  HybridSchrodingerFeynmanSimulator sim(std::move(qc));
-  EXPECT_THROW(sim.simulate(1024), std::invalid_argument);
+  const auto expected = referenceVector(quantumComputation());
+
+  HybridSchrodingerFeynmanSimulator sim(
+      quantumComputation(),
+      HybridSchrodingerFeynmanSimulator<>::Mode::Amplitude);
+  // the Schmidt rank of an RZZ gate is two
+  EXPECT_EQ(sim.getNDecisions(1), 1U);
+  sim.simulate(0);
+
+  expectSameVector(expected, sim.getVectorFromHybridSimulation());
 }
 
 TEST(HybridSimTest, TwoControlGateSupportLowerHalf) {
-  auto qc = std::make_unique<qc::QuantumComputation>(4);
-  qc->mcx({0, 1}, 2);
-  std::cout << *qc << "\n";
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    qc->h(0);
+    qc->h(1);
+    qc->mcx({0, 1}, 2);
+    return qc;
+  };
 
-  HybridSchrodingerFeynmanSimulator sim(std::move(qc));
-  EXPECT_THROW(sim.simulate(1024), std::invalid_argument);
+  const auto expected = referenceVector(quantumComputation());
+
+  HybridSchrodingerFeynmanSimulator sim(
+      quantumComputation(), HybridSchrodingerFeynmanSimulator<>::Mode::DD);
+  EXPECT_EQ(sim.getNDecisions(2), 1U);
+  sim.simulate(0);
+
+  expectSameVector(expected, sim.getVectorFromHybridSimulation());
 }
 
 TEST(HybridSimTest, TwoControlGateSupportUpperHalf) {
-  auto qc = std::make_unique<qc::QuantumComputation>(4);
-  qc->mcx({3, 2}, 1);
-  std::cout << *qc << "\n";
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    qc->h(2);
+    qc->h(3);
+    qc->mcx({3, 2}, 1);
+    return qc;
+  };
 
-  HybridSchrodingerFeynmanSimulator sim(std::move(qc));
-  EXPECT_THROW(sim.simulate(1024), std::invalid_argument);
+  const auto expected = referenceVector(quantumComputation());
+
+  HybridSchrodingerFeynmanSimulator sim(
+      quantumComputation(), HybridSchrodingerFeynmanSimulator<>::Mode::DD);
+  EXPECT_EQ(sim.getNDecisions(2), 1U);
+  sim.simulate(0);
+
+  expectSameVector(expected, sim.getVectorFromHybridSimulation());
+}
+
+TEST(HybridSimTest, SchmidtDecompositionCuts) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    for (qc::Qubit q = 0; q < 4; ++q) {
+      qc->h(q);
+    }
+    qc->rzz(0.7, 1, 2);
+    qc->t(1);
+    qc->swap(1, 2);
+    qc->ry(0.3, 2);
+    qc->mcx({0, 1}, 3);
+    qc->mcx({1, 2}, 3);
+    return qc;
+  };
+
+  const auto expected = referenceVector(quantumComputation());
+
+  using Mode = HybridSchrodingerFeynmanSimulator<>::Mode;
+  for (const auto mode : {Mode::DD, Mode::Amplitude}) {
+    for (const bool prefixSharing : {false, true}) {
+      HybridSchrodingerFeynmanSimulator ddsim(quantumComputation(), mode, 2);
+      ddsim.setPrefixSharing(prefixSharing);
+      ddsim.simulate(0);
+      // RZZ (rank 2), SWAP (rank 4), and two Toffolis with a single bit each
+      EXPECT_EQ(ddsim.additionalStatistics().at("decisions"), "5");
+
+      expectSameVector(expected, ddsim.getVectorFromHybridSimulation());
+    }
+  }
+
+  auto crossing = std::make_unique<qc::QuantumComputation>(6);
+  crossing->mcx({0, 2}, 4);
+  HybridSchrodingerFeynmanSimulator invalid(std::move(crossing));
+  invalid.setSplitQubits({2, 4});
+  EXPECT_THROW(invalid.simulate(1024), std::invalid_argument);
+}
+
+TEST(HybridSimTest, RepeatedCutGates) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    for (qc::Qubit q = 0; q < 4; ++q) {
+      qc->h(q);
+    }
+    // the first two gates act alike on the cut and share their decomposition
+    qc->rzz(0.7, 1, 2);
+    qc->t(0);
+    qc->rzz(0.7, 0, 3);
+    qc->ry(0.4, 3);
+    qc->rzz(1.1, 1, 3);
+    qc->swap(1, 2);
+    qc->s(1);
+    qc->swap(0, 3);
+    return qc;
+  };
+
+  const auto expected = referenceVector(quantumComputation());
+
+  using Mode = HybridSchrodingerFeynmanSimulator<>::Mode;
+  for (const auto mode : {Mode::DD, Mode::Amplitude}) {
+    for (const bool prefixSharing : {false, true}) {
+      HybridSchrodingerFeynmanSimulator ddsim(quantumComputation(), mode, 2);
+      ddsim.setPrefixSharing(prefixSharing);
+      // three RZZs (rank 2) and two SWAPs (rank 4)
+      EXPECT_EQ(ddsim.getNDecisions(2), 7U);
+      ddsim.simulate(0);
+      EXPECT_EQ(ddsim.additionalStatistics().at("decisions"), "7");
+
+      expectSameVector(expected, ddsim.getVectorFromHybridSimulation());
+    }
+  }
+}
+
+TEST(HybridSimTest, AutomaticSplitAvoidsCrossingGates) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(6);
+    for (qc::Qubit q = 0; q < 6; ++q) {
+      qc->h(q);
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+      qc->cx(0, 1);
+      qc->cx(1, 2);
+      qc->cx(2, 3);
+      qc->rz(0.3, 3);
+    }
+    qc->cx(4, 5);
+    return qc;
+  };
+
+  HybridSchrodingerFeynmanSimulator reference(
+      quantumComputation(),
+      HybridSchrodingerFeynmanSimulator<>::Mode::Amplitude);
+  reference.simulate(0);
+  EXPECT_EQ(reference.getSplitQubit(), 3U);
+  EXPECT_EQ(reference.additionalStatistics().at("decisions"), "3");
+
+  HybridSchrodingerFeynmanSimulator ddsim(
+      quantumComputation(),
+      HybridSchrodingerFeynmanSimulator<>::Mode::Amplitude);
+  ddsim.setAutomaticSplit(true);
+  EXPECT_EQ(ddsim.planSplitQubit(), 4U);
+  ddsim.simulate(0);
+  EXPECT_EQ(ddsim.getSplitQubit(), 4U);
+  EXPECT_EQ(ddsim.additionalStatistics().at("decisions"), "0");
+
+  expectSameVector(reference.getVectorFromHybridSimulation(),
+                   ddsim.getVectorFromHybridSimulation());
+}
+
+TEST(HybridSimTest, MultipleCuts) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(6);
+    for (qc::Qubit q = 0; q < 6; ++q) {
+      qc->h(q);
+    }
+    qc->cx(0, 1);
+    qc->cx(1, 2);
+    qc->cx(3, 2);
+    qc->rz(0.4, 2);
+    qc->cx(2, 3);
+    qc->cz(3, 4);
+    qc->cx(4, 5);
+    qc->cx(5, 0);
+    return qc;
+  };
+
+  using Mode = HybridSchrodingerFeynmanSimulator<>::Mode;
+  for (const auto mode : {Mode::DD, Mode::Amplitude}) {
+    const auto expected = referenceVector(quantumComputation());
+
+    HybridSchrodingerFeynmanSimulator ddsim(quantumComputation(), mode);
+    ddsim.setSplitQubits({4, 2});
+    EXPECT_EQ(ddsim.getSplitQubits(), (std::vector<qc::Qubit>{2, 4}));
+    EXPECT_EQ(ddsim.getNDecisions(ddsim.getSplitQubits()), 3U);
+    ddsim.simulate(0);
+    EXPECT_EQ(ddsim.additionalStatistics().at("slices"), "3");
+
+    expectSameVector(expected, ddsim.getVectorFromHybridSimulation());
+  }
+
+  HybridSchrodingerFeynmanSimulator invalid(quantumComputation());
+  EXPECT_THROW(invalid.setSplitQubits({0, 3}), std::invalid_argument);
+  EXPECT_THROW(invalid.setSplitQubits({6}), std::invalid_argument);
+}
+
+TEST(HybridSimTest, PrefixSharing) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    for (qc::Qubit q = 0; q < 4; ++q) {
+      qc->h(q);
+    }
+    qc->cx(1, 2);
+    qc->rz(0.2, 2);
+    qc->cx(2, 1);
+    qc->ry(0.7, 0);
+    qc->cx(0, 3);
+    qc->rx(0.5, 3);
+    qc->cz(3, 1);
+    qc->h(0);
+    return qc;
+  };
+  constexpr std::size_t nops = 12;
+  constexpr std::size_t npaths = 1U << 4U;
+
+  using Mode = HybridSchrodingerFeynmanSimulator<>::Mode;
+  for (const auto mode : {Mode::DD, Mode::Amplitude}) {
+    const auto expected = referenceVector(quantumComputation());
+
+    for (const std::size_t maxCheckpoints : {0U, 1U, 16U}) {
+      HybridSchrodingerFeynmanSimulator ddsim(quantumComputation(), mode, 1);
+      ddsim.setPrefixSharing(true);
+      ddsim.setMaxCheckpoints(maxCheckpoints);
+      ddsim.simulate(0);
+      EXPECT_EQ(ddsim.additionalStatistics().at("decisions"), "4");
+      if (maxCheckpoints == 0) {
+        // every path is replayed from the beginning
+        EXPECT_EQ(ddsim.getAppliedOperations(), nops * npaths);
+      } else {
+        EXPECT_LT(ddsim.getAppliedOperations(), nops * npaths);
+      }
+
+      expectSameVector(expected, ddsim.getVectorFromHybridSimulation());
+    }
+  }
+}
+
+TEST(HybridSimTest, SpillPartialResults) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    for (qc::Qubit q = 0; q < 4; ++q) {
+      qc->h(q);
+    }
+    qc->cx(1, 2);
+    qc->rz(0.2, 2);
+    qc->cx(2, 1);
+    qc->cx(0, 3);
+    qc->rx(0.5, 3);
+    qc->cz(3, 1);
+    return qc;
+  };
+
+  const auto expected = referenceVector(quantumComputation());
+
+  const auto scratch =
+      std::filesystem::temp_directory_path() / "ddsim_test_scratch";
+  std::filesystem::remove_all(scratch);
+
+  for (const std::size_t threshold :
+       {std::numeric_limits<std::size_t>::max(), std::size_t{0}}) {
+    HybridSchrodingerFeynmanSimulator ddsim(
+        quantumComputation(), HybridSchrodingerFeynmanSimulator<>::Mode::DD,
+        4);
+    ddsim.setSpillThreshold(threshold);
+    ddsim.setScratchDirectory(scratch.string());
+    ddsim.simulate(0);
+    if (threshold == 0) {
+      EXPECT_GT(ddsim.getSpilledResults(), 0U);
+      // the job-specific directory has been removed again
+      EXPECT_TRUE(std::filesystem::is_empty(scratch));
+    } else {
+      EXPECT_EQ(ddsim.getSpilledResults(), 0U);
+    }
+
+    expectSameVector(expected, ddsim.getVectorFromHybridSimulation());
+  }
+  std::filesystem::remove_all(scratch);
+}
+
+TEST(HybridSimTest, SingleAmplitudeBuffer) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(5);
+    for (qc::Qubit q = 0; q < 5; ++q) {
+      qc->h(q);
+    }
+    qc->cx(1, 3);
+    qc->rz(0.3, 3);
+    qc->cx(4, 0);
+    qc->ry(0.6, 2);
+    qc->cx(2, 3);
+    qc->cz(3, 1);
+    return qc;
+  };
+
+  const auto expected = referenceVector(quantumComputation());
+
+  for (const bool prefixSharing : {false, true}) {
+    HybridSchrodingerFeynmanSimulator ddsim(
+        quantumComputation(),
+        HybridSchrodingerFeynmanSimulator<>::Mode::Amplitude, 4);
+    ddsim.setSingleAmplitudeBuffer(true);
+    ddsim.setPrefixSharing(prefixSharing);
+    ddsim.simulate(0);
+    EXPECT_EQ(ddsim.additionalStatistics().at("decisions"), "3");
+
+    expectSameVector(expected, ddsim.getVectorFromHybridSimulation());
+  }
+}
+
+TEST(HybridSimTest, GetAmplitudes) {
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(5);
+    for (qc::Qubit q = 0; q < 5; ++q) {
+      qc->h(q);
+    }
+    qc->cx(1, 3);
+    qc->rz(0.3, 3);
+    qc->cx(4, 0);
+    qc->ry(0.6, 2);
+    qc->cx(2, 3);
+    qc->cz(3, 1);
+    qc->t(4);
+    return qc;
+  };
+
+  const auto expected = referenceVector(quantumComputation());
+
+  const std::vector<std::string> bitstrings{"00000", "10110", "01011",
+                                            "11111"};
+  for (const bool prefixSharing : {false, true}) {
+    HybridSchrodingerFeynmanSimulator ddsim(quantumComputation());
+    ddsim.setSplitQubits({2, 4});
+    ddsim.setPrefixSharing(prefixSharing);
+    const auto amplitudes = ddsim.getAmplitudes(bitstrings);
+    ASSERT_EQ(amplitudes.size(), bitstrings.size());
+    for (std::size_t i = 0; i < bitstrings.size(); ++i) {
+      const auto index = std::stoull(bitstrings[i], nullptr, 2);
+      EXPECT_NEAR(expected[index].real(), amplitudes[i].real(), 1e-8);
+      EXPECT_NEAR(expected[index].imag(), amplitudes[i].imag(), 1e-8);
+    }
+  }
+
+  HybridSchrodingerFeynmanSimulator invalid(quantumComputation());
+  EXPECT_THROW(invalid.getAmplitudes({"0000"}), std::invalid_argument);
+  EXPECT_THROW(invalid.getAmplitudes({"01020"}), std::invalid_argument);
+}
+
+TEST(HybridSimTest, WorkerProcesses) {
+  if (!WorkerPool::isSupported()) {
+    GTEST_SKIP() << "Worker processes are not supported on this platform.";
+  }
+
+  auto quantumComputation = [] {
+    auto qc = std::make_unique<qc::QuantumComputation>(4);
+    for (qc::Qubit q = 0; q < 4; ++q) {
+      qc->h(q);
+    }
+    qc->cx(1, 2);
+    qc->rz(0.2, 2);
+    qc->cx(2, 1);
+    qc->cx(0, 3);
+    qc->rx(0.5, 3);
+    qc->cz(3, 1);
+    return qc;
+  };
+
+  const auto expected = referenceVector(quantumComputation());
+
+  using Mode = HybridSchrodingerFeynmanSimulator<>::Mode;
+  for (const auto mode : {Mode::DD, Mode::Amplitude}) {
+    for (const bool prefixSharing : {false, true}) {
+      // the workers split their ranges over their threads
+      for (const std::size_t nthreads : {1U, 2U}) {
+        HybridSchrodingerFeynmanSimulator ddsim(quantumComputation(), mode,
+                                                nthreads);
+        ddsim.setNumberOfProcesses(3);
+        ddsim.setPrefixSharing(prefixSharing);
+        // the threads of a worker share its buffer
+        ddsim.setSingleAmplitudeBuffer(nthreads > 1);
+        ddsim.simulate(0);
+        EXPECT_EQ(ddsim.additionalStatistics().at("processes"), "3");
+        EXPECT_GT(ddsim.getAppliedOperations(), 0U);
+
+        expectSameVector(expected, ddsim.getVectorFromHybridSimulation());
+      }
+    }
+  }
 }
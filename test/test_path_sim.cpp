@@ -6,14 +6,34 @@
 #include "ir/operations/OpType.hpp"
 
 #include <complex>
+#include <cstddef>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 using namespace qc::literals;
 
+namespace {
+void expectSameVector(const dd::CVec& expected, const dd::CVec& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(expected[i].real(), actual[i].real(), 1e-8);
+    EXPECT_NEAR(expected[i].imag(), actual[i].imag(), 1e-8);
+  }
+}
+
+// the state vector of Grover's algorithm simulated serially along the path
+// of the given configuration
+dd::CVec groverReferenceVector(const PathSimulator<>::Configuration& config) {
+  PathSimulator reference(std::make_unique<qc::Grover>(4, 12345), config);
+  reference.simulate(1);
+  return reference.getVector();
+}
+} // namespace
+
 TEST(TaskBasedSimTest, Configuration) {
   EXPECT_EQ(PathSimulator<>::Configuration::modeToString(
                 PathSimulator<>::Configuration::Mode::Sequential),
@@ -34,6 +54,12 @@ TEST(TaskBasedSimTest, Configuration) {
   EXPECT_EQ(PathSimulator<>::Configuration::modeToString(
                 PathSimulator<>::Configuration::Mode::GateCost),
             "gate_cost");
+  EXPECT_EQ(PathSimulator<>::Configuration::modeToString(
+                PathSimulator<>::Configuration::Mode::CostModel),
+            "cost_model");
+  EXPECT_EQ(PathSimulator<>::Configuration::modeToString(
+                PathSimulator<>::Configuration::Mode::Adaptive),
+            "adaptive");
   EXPECT_THROW(
       PathSimulator<>::Configuration::modeToString(
           // NOLINTNEXTLINE(clang-analyzer-optin.core.EnumCastOutOfRange)
@@ -53,6 +79,10 @@ TEST(TaskBasedSimTest, Configuration) {
             PathSimulator<>::Configuration::Mode::Cotengra);
   EXPECT_EQ(PathSimulator<>::Configuration::modeFromString("gate_cost"),
             PathSimulator<>::Configuration::Mode::GateCost);
+  EXPECT_EQ(PathSimulator<>::Configuration::modeFromString("cost_model"),
+            PathSimulator<>::Configuration::Mode::CostModel);
+  EXPECT_EQ(PathSimulator<>::Configuration::modeFromString("adaptive"),
+            PathSimulator<>::Configuration::Mode::Adaptive);
   EXPECT_THROW(
       PathSimulator<>::Configuration::modeFromString("invalid argument"),
       std::invalid_argument);
@@ -307,3 +337,203 @@ TEST(TaskBasedSimTest, DynamicCircuitSupport) {
   PathSimulator sim(std::move(qc));
   EXPECT_THROW(sim.simulate(1024), std::invalid_argument);
 }
+
+TEST(TaskBasedSimTest, ParallelMatchesSerial) {
+  for (const auto mode :
+       {PathSimulator<>::Configuration::Mode::PairwiseRecursiveGrouping,
+        PathSimulator<>::Configuration::Mode::BracketGrouping}) {
+    auto config = PathSimulator<>::Configuration{};
+    config.mode = mode;
+    config.bracketSize = 3;
+
+    PathSimulator parallel(std::make_unique<qc::Grover>(4, 12345), config);
+    parallel.setNumberOfThreads(4);
+    EXPECT_EQ(parallel.getNumberOfThreads(), 4);
+    parallel.simulate(1);
+
+    expectSameVector(groverReferenceVector(config), parallel.getVector());
+  }
+}
+
+TEST(TaskBasedSimTest, ParallelEmptyCircuit) {
+  PathSimulator tbs(std::make_unique<qc::QuantumComputation>(2));
+  tbs.setNumberOfThreads(2);
+
+  const auto shots = 1024U;
+  const auto counts = tbs.simulate(shots);
+  ASSERT_EQ(counts.size(), 1U);
+  EXPECT_EQ(counts.at("00"), shots);
+}
+
+TEST(TaskBasedSimTest, GroverCircuitCostModel) {
+  std::unique_ptr<qc::QuantumComputation> qc =
+      std::make_unique<qc::Grover>(4, 12345);
+  auto* grover = dynamic_cast<qc::Grover*>(qc.get());
+  auto targetValue = grover->targetValue;
+  const auto nops = qc->getNops();
+
+  auto config = PathSimulator<>::Configuration{};
+  config.mode = PathSimulator<>::Configuration::Mode::CostModel;
+  PathSimulator tbs(std::move(qc), config);
+
+  // every operation is contracted exactly once
+  EXPECT_EQ(tbs.getSimulationPath().components.size(), nops);
+
+  tbs.simulate(1024);
+
+  const auto target = targetValue.to_ullong() | (1ULL << 4);
+  const auto c = tbs.rootEdge.getValueByIndex(target);
+  EXPECT_GT(std::norm(c), 0.9);
+}
+
+TEST(TaskBasedSimTest, CostModelLargeCircuit) {
+  // planning only re-evaluates the pairs next to each contraction, so large
+  // circuits are planned quickly
+  constexpr std::size_t nqubits = 8;
+  auto qc = std::make_unique<qc::QuantumComputation>(nqubits);
+  for (std::size_t i = 0; i < 20000; ++i) {
+    const auto q = static_cast<qc::Qubit>(i % nqubits);
+    if (i % 3 == 0) {
+      qc->cx(q, static_cast<qc::Qubit>((q + 1) % nqubits));
+    } else {
+      qc->h(q);
+    }
+  }
+  const auto nops = qc->getNops();
+
+  auto config = PathSimulator<>::Configuration{};
+  config.mode = PathSimulator<>::Configuration::Mode::CostModel;
+  const PathSimulator tbs(std::move(qc), config);
+  EXPECT_EQ(tbs.getSimulationPath().components.size(), nops);
+}
+
+TEST(TaskBasedSimTest, GroverCircuitAdaptive) {
+  std::unique_ptr<qc::QuantumComputation> qc =
+      std::make_unique<qc::Grover>(4, 12345);
+  auto* grover = dynamic_cast<qc::Grover*>(qc.get());
+  auto targetValue = grover->targetValue;
+  const auto nops = qc->getNops();
+
+  auto config = PathSimulator<>::Configuration{};
+  config.mode = PathSimulator<>::Configuration::Mode::Adaptive;
+  PathSimulator tbs(std::move(qc), config);
+  tbs.simulate(1024);
+
+  const auto target = targetValue.to_ullong() | (1ULL << 4);
+  EXPECT_GT(std::norm(tbs.rootEdge.getValueByIndex(target)), 0.9);
+
+  // the chosen path is recorded and can be replayed
+  const auto components = tbs.getSimulationPath().components;
+  EXPECT_EQ(components.size(), nops);
+  const auto statistics = tbs.additionalStatistics();
+  EXPECT_EQ(std::stoul(statistics.at("adaptive_matrix_vector_steps")) +
+                std::stoul(statistics.at("adaptive_matrix_matrix_steps")),
+            nops);
+
+  PathSimulator replay(std::make_unique<qc::Grover>(4, 12345));
+  replay.setSimulationPath(components, true);
+  replay.simulate(1024);
+  EXPECT_GT(std::norm(replay.rootEdge.getValueByIndex(target)), 0.9);
+}
+
+TEST(TaskBasedSimTest, SimulateCompactFollowsMode) {
+  std::unique_ptr<qc::QuantumComputation> qc =
+      std::make_unique<qc::Grover>(4, 12345);
+  auto* grover = dynamic_cast<qc::Grover*>(qc.get());
+  auto targetValue = grover->targetValue;
+  const auto nops = qc->getNops();
+
+  auto config = PathSimulator<>::Configuration{};
+  config.mode = PathSimulator<>::Configuration::Mode::Adaptive;
+  PathSimulator tbs(std::move(qc), config);
+  const auto counts = tbs.simulateCompact(1024);
+  EXPECT_FALSE(counts.empty());
+
+  const auto target = targetValue.to_ullong() | (1ULL << 4);
+  EXPECT_GT(std::norm(tbs.rootEdge.getValueByIndex(target)), 0.9);
+
+  // the adaptive mode decided on every contraction
+  const auto statistics = tbs.additionalStatistics();
+  EXPECT_EQ(std::stoul(statistics.at("adaptive_matrix_vector_steps")) +
+                std::stoul(statistics.at("adaptive_matrix_matrix_steps")),
+            nops);
+}
+
+TEST(TaskBasedSimTest, MemoryAwareScheduling) {
+  auto config = PathSimulator<>::Configuration{};
+  config.mode = PathSimulator<>::Configuration::Mode::PairwiseRecursiveGrouping;
+
+  PathSimulator tbs(std::make_unique<qc::Grover>(4, 12345), config);
+  tbs.setMemoryAwareScheduling(true);
+  EXPECT_TRUE(tbs.getMemoryAwareScheduling());
+  tbs.simulate(1);
+
+  expectSameVector(groverReferenceVector(config), tbs.getVector());
+
+  EXPECT_GT(tbs.getPeakLiveNodes(), 0U);
+  EXPECT_EQ(tbs.additionalStatistics().at("peak_live_nodes"),
+            std::to_string(tbs.getPeakLiveNodes()));
+}
+
+TEST(TaskBasedSimTest, MemoryAwareSchedulingLowersPeak) {
+  constexpr std::size_t npairs = 32;
+  auto qc = std::make_unique<qc::QuantumComputation>(3);
+  for (std::size_t i = 0; i < npairs; ++i) {
+    qc->cx(0, 1);
+    qc->cx(1, 2);
+  }
+  const std::size_t nleaves = qc->getNops() + 1;
+
+  // the path lists all products of neighboring gates before any of them is
+  // applied to the state, so following it would keep all products alive
+  PathSimulator<>::SimulationPath::Components components{};
+  for (std::size_t i = 0; i < npairs; ++i) {
+    components.emplace_back((2 * i) + 1, (2 * i) + 2);
+  }
+  components.emplace_back(0, nleaves);
+  for (std::size_t i = 1; i < npairs; ++i) {
+    components.emplace_back(nleaves + npairs + i - 1, nleaves + i);
+  }
+
+  PathSimulator tbs(std::move(qc));
+  tbs.setSimulationPath(components, true);
+  tbs.setMemoryAwareScheduling(true);
+  const auto counts = tbs.simulate(16);
+  ASSERT_EQ(counts.size(), 1U);
+  EXPECT_EQ(counts.begin()->first, "000");
+
+  // every product has at least one node besides the terminal, whereas the
+  // scheduler applies each product to the state right after computing it
+  EXPECT_GT(tbs.getPeakLiveNodes(), 0U);
+  EXPECT_LT(tbs.getPeakLiveNodes(), 2 * npairs);
+}
+
+TEST(TaskBasedSimTest, GateCacheDeduplicatesGates) {
+  auto qc = std::make_unique<qc::QuantumComputation>(2);
+  qc->h(1U);
+  for (std::size_t i = 0; i < 8; ++i) {
+    qc->cx(1, 0);
+  }
+  qc->rz(0.5, 0);
+  qc->rz(0.25, 0);
+
+  auto config = PathSimulator<>::Configuration{};
+  config.mode = PathSimulator<>::Configuration::Mode::PairwiseRecursiveGrouping;
+  PathSimulator tbs(std::move(qc), config);
+  EXPECT_EQ(tbs.getGateCacheCapacity(), 256U);
+  const auto counts = tbs.simulate(1024);
+  EXPECT_EQ(counts.size(), 2U);
+
+  // h, cx, and both rotations are only constructed once
+  const auto statistics = tbs.additionalStatistics();
+  EXPECT_EQ(statistics.at("gate_cache_misses"), "4");
+  EXPECT_EQ(statistics.at("gate_cache_hits"), "7");
+
+  auto uncached = std::make_unique<qc::QuantumComputation>(2);
+  uncached->h(1U);
+  uncached->cx(1, 0);
+  PathSimulator reference(std::move(uncached), config);
+  reference.setGateCacheCapacity(0);
+  reference.simulate(1);
+  EXPECT_EQ(reference.additionalStatistics().at("gate_cache_hits"), "0");
+}
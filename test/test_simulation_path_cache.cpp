@@ -0,0 +1,121 @@
+#include "PathSimulator.hpp"
+#include "SimulationPathCache.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+std::unique_ptr<qc::QuantumComputation> ansatz(const double theta) {
+  auto qc = std::make_unique<qc::QuantumComputation>(3);
+  for (qc::Qubit q = 0; q < 3; ++q) {
+    qc->ry(theta * static_cast<double>(q + 1), q);
+  }
+  qc->cx(0, 1);
+  qc->cx(1, 2);
+  for (qc::Qubit q = 0; q < 3; ++q) {
+    qc->rz(theta / static_cast<double>(q + 1), q);
+  }
+  return qc;
+}
+
+class SimulationPathCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    directory = (std::filesystem::temp_directory_path() /
+                 ("ddsim_path_cache_" +
+                  std::string(testing::UnitTest::GetInstance()
+                                  ->current_test_info()
+                                  ->name())))
+                    .string();
+    std::filesystem::remove_all(directory);
+  }
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  std::string directory;
+};
+} // namespace
+
+TEST_F(SimulationPathCacheTest, StructuralHashIgnoresParameters) {
+  EXPECT_EQ(SimulationPathCache::structuralHash(*ansatz(0.1)),
+            SimulationPathCache::structuralHash(*ansatz(2.3)));
+
+  auto other = ansatz(0.1);
+  other->cx(2, 0);
+  EXPECT_NE(SimulationPathCache::structuralHash(*ansatz(0.1)),
+            SimulationPathCache::structuralHash(*other));
+
+  auto swapped = std::make_unique<qc::QuantumComputation>(2);
+  swapped->cx(0, 1);
+  auto reversed = std::make_unique<qc::QuantumComputation>(2);
+  reversed->cx(1, 0);
+  EXPECT_NE(SimulationPathCache::structuralHash(*swapped),
+            SimulationPathCache::structuralHash(*reversed));
+}
+
+TEST_F(SimulationPathCacheTest, StoreAndLookup) {
+  const SimulationPathCache cache(directory);
+  const SimulationPathCache::Components components{{0, 1}, {3, 2}};
+  EXPECT_FALSE(cache.lookup(42, 3).has_value());
+
+  cache.store(42, 3, components);
+  const auto loaded = cache.lookup(42, 3);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(*loaded, components);
+
+  // entries for a different number of leaves are rejected
+  EXPECT_FALSE(cache.lookup(42, 4).has_value());
+  EXPECT_FALSE(cache.lookup(43, 3).has_value());
+}
+
+TEST_F(SimulationPathCacheTest, ConcurrentStoresOfSameKey) {
+  const SimulationPathCache cache(directory);
+  const SimulationPathCache::Components components{{0, 1}, {3, 2}};
+
+  std::vector<std::thread> writers;
+  for (std::size_t i = 0; i < 8; ++i) {
+    writers.emplace_back([&cache, &components] {
+      for (std::size_t j = 0; j < 16; ++j) {
+        cache.store(42, 3, components);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+
+  const auto loaded = cache.lookup(42, 3);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(*loaded, components);
+  // every writer renamed its own temporary file into place
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    EXPECT_NE(entry.path().extension(), ".tmp");
+  }
+}
+
+TEST_F(SimulationPathCacheTest, PathSimulatorReusesPath) {
+  auto config = PathSimulator<>::Configuration{};
+  config.mode = PathSimulator<>::Configuration::Mode::CostModel;
+  config.pathCache = directory;
+
+  PathSimulator first(ansatz(0.1), config);
+  EXPECT_FALSE(first.isSimulationPathCached());
+  first.simulate(16);
+
+  PathSimulator second(ansatz(0.7), config);
+  EXPECT_TRUE(second.isSimulationPathCached());
+  EXPECT_EQ(second.getSimulationPath().components,
+            first.getSimulationPath().components);
+  second.simulate(16);
+
+  // a different strategy does not reuse the path
+  config.mode = PathSimulator<>::Configuration::Mode::PairwiseRecursiveGrouping;
+  const PathSimulator third(ansatz(0.1), config);
+  EXPECT_FALSE(third.isSimulationPathCached());
+}
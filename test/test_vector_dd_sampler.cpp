@@ -0,0 +1,107 @@
+#include "CircuitSimulator.hpp"
+#include "PackedBitString.hpp"
+#include "VectorDDSampler.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+
+TEST(VectorDDSamplerTest, PackedBitStringConversion) {
+  PackedBitString bits(2, 0U);
+  bits[0] = 0b101U;
+  bits[1] = 1U; // qubit 64
+  const auto str = toBitString(bits, 65);
+  ASSERT_EQ(str.size(), 65);
+  EXPECT_EQ(str.front(), '1');
+  EXPECT_EQ(str.substr(62), "101");
+  EXPECT_EQ(str.substr(1, 61), std::string(61, '0'));
+}
+
+TEST(VectorDDSamplerTest, BasisStateIsSampledDeterministically) {
+  auto qc = std::make_unique<qc::QuantumComputation>(3);
+  qc->x(0);
+  qc->x(2);
+  CircuitSimulator ddsim(std::move(qc));
+  ddsim.simulate(0);
+
+  const VectorDDSampler sampler(ddsim.rootEdge, 3);
+  std::mt19937_64 mt(42U);
+  const auto histogram = sampler.sample(100, mt);
+  ASSERT_EQ(histogram.size(), 1);
+  EXPECT_EQ(toBitString(histogram.begin()->first, 3), "101");
+  EXPECT_EQ(histogram.begin()->second, 100);
+}
+
+TEST(VectorDDSamplerTest, GhzStateIsSampledCorrectly) {
+  auto qc = std::make_unique<qc::QuantumComputation>(4);
+  qc->h(3);
+  qc->cx(3, 2);
+  qc->cx(2, 1);
+  qc->cx(1, 0);
+  CircuitSimulator ddsim(std::move(qc), 1337);
+  const auto result = ddsim.simulate(10000);
+
+  ASSERT_EQ(result.size(), 2);
+  std::size_t total = 0;
+  for (const auto& [bitstring, count] : result) {
+    EXPECT_TRUE(bitstring == "0000" || bitstring == "1111");
+    EXPECT_NEAR(static_cast<double>(count), 5000., 300.);
+    total += count;
+  }
+  EXPECT_EQ(total, 10000);
+}
+
+TEST(VectorDDSamplerTest, SamplingIsReproducible) {
+  auto qc = std::make_unique<qc::QuantumComputation>(5);
+  for (qc::Qubit q = 0; q < 5; ++q) {
+    qc->h(q);
+  }
+  CircuitSimulator ddsim(std::move(qc));
+  ddsim.simulate(0);
+
+  const VectorDDSampler sampler(ddsim.rootEdge, 5);
+  std::mt19937_64 mt1(7U);
+  std::mt19937_64 mt2(7U);
+  EXPECT_EQ(sampler.sample(1000, mt1), sampler.sample(1000, mt2));
+}
+
+TEST(VectorDDSamplerTest, ParallelSamplingIndependentOfThreadCount) {
+  auto qc = std::make_unique<qc::QuantumComputation>(6);
+  for (qc::Qubit q = 0; q < 6; ++q) {
+    qc->h(q);
+  }
+  CircuitSimulator ddsim(std::move(qc));
+  ddsim.simulate(0);
+
+  const VectorDDSampler sampler(ddsim.rootEdge, 6);
+  constexpr std::size_t shots = 300000;
+  std::mt19937_64 mt1(42U);
+  std::mt19937_64 mt2(42U);
+  const auto serial = sampler.sample(shots, mt1, 1);
+  const auto parallel = sampler.sample(shots, mt2, 4);
+  EXPECT_EQ(serial, parallel);
+  EXPECT_EQ(serial.size(), 64);
+
+  std::size_t total = 0;
+  for (const auto& [bits, count] : parallel) {
+    total += count;
+  }
+  EXPECT_EQ(total, shots);
+}
+
+TEST(VectorDDSamplerTest, SimulatorSamplingThreads) {
+  auto qc = std::make_unique<qc::QuantumComputation>(3);
+  qc->h(0);
+  qc->cx(0, 1);
+  qc->cx(0, 2);
+  CircuitSimulator ddsim(std::move(qc), 1337);
+  ddsim.setSamplingThreads(4);
+  EXPECT_EQ(ddsim.getSamplingThreads(), 4);
+  const auto result = ddsim.simulate(200000);
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_EQ(result.at("000") + result.at("111"), 200000);
+}
@@ -0,0 +1,102 @@
+#include "WorkerPool.hpp"
+
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+class WorkerPoolTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (!WorkerPool::isSupported()) {
+      GTEST_SKIP() << "Worker processes are not supported on this platform.";
+    }
+  }
+
+  // whether all worker processes have been reaped
+  static bool noChildProcesses() {
+#ifndef _WIN32
+    return ::waitpid(-1, nullptr, WNOHANG) == -1 && errno == ECHILD;
+#else
+    return true;
+#endif
+  }
+};
+} // namespace
+
+TEST_F(WorkerPoolTest, ProcessesAllItems) {
+  // every worker reports the sum of the items it processed
+  std::size_t sum = 0;
+  const auto process = [&sum](const std::size_t first,
+                              const std::size_t count) {
+    for (auto item = first; item < first + count; ++item) {
+      sum += item;
+    }
+  };
+  const auto finish = [&sum]() { return std::to_string(sum); };
+  std::size_t total = 0;
+  const auto collect = [&total](std::string&& result) {
+    total += std::stoull(result);
+  };
+
+  WorkerPool(3).run(100, 7, process, finish, collect);
+  EXPECT_EQ(total, 99U * 100U / 2U);
+  EXPECT_TRUE(noChildProcesses());
+}
+
+TEST_F(WorkerPoolTest, ForwardsWorkerErrors) {
+  const auto process = [](const std::size_t first, const std::size_t count) {
+    if (first <= 42 && 42 < first + count) {
+      throw std::invalid_argument("item 42 is invalid");
+    }
+  };
+  const auto finish = []() { return std::string(); };
+  const auto collect = [](std::string&& /*result*/) {};
+
+  try {
+    WorkerPool(3).run(100, 7, process, finish, collect);
+    FAIL() << "Expected the error of the worker to be rethrown.";
+  } catch (const std::runtime_error& e) {
+    EXPECT_NE(std::string(e.what()).find("item 42 is invalid"),
+              std::string::npos);
+  }
+  EXPECT_TRUE(noChildProcesses());
+}
+
+TEST_F(WorkerPoolTest, ForwardsErrorsOfFinish) {
+  const auto process = [](const std::size_t /*first*/,
+                          const std::size_t /*count*/) {};
+  const auto finish = []() -> std::string {
+    throw std::runtime_error("no result");
+  };
+  const auto collect = [](std::string&& /*result*/) {};
+
+  EXPECT_THROW(WorkerPool(2).run(10, 3, process, finish, collect),
+               std::runtime_error);
+  EXPECT_TRUE(noChildProcesses());
+}
+
+TEST_F(WorkerPoolTest, WorkerExitingEarly) {
+  const auto process = []([[maybe_unused]] const std::size_t first,
+                          const std::size_t /*count*/) {
+#ifndef _WIN32
+    if (first == 0) {
+      // terminate without reporting anything to the coordinator
+      ::_exit(0);
+    }
+#endif
+  };
+  const auto finish = []() { return std::string(); };
+  const auto collect = [](std::string&& /*result*/) {};
+
+  EXPECT_THROW(WorkerPool(3).run(100, 7, process, finish, collect),
+               std::runtime_error);
+  EXPECT_TRUE(noChildProcesses());
+}